@@ -0,0 +1,46 @@
+#include "Constants.h"
+
+#include <iostream>
+#include <string>
+#include <SDL2/SDL.h>
+
+namespace Constants {
+  char const * const ApplicationName(void) {
+    static const char result[] = "SDL_Benchmark";
+    return result;
+  }
+  std::string ResourcePath(const std::string &directory = "") {
+    #ifdef _WIN32
+      const char PATH_SEP = '\\';
+    #else
+      const char PATH_SEP = '/';
+    #endif
+
+    static std::string basePath;
+    if (basePath.empty()) {
+      char *sdlBasePath = SDL_GetBasePath();
+      if (sdlBasePath) {
+        basePath = sdlBasePath;
+        SDL_free(sdlBasePath);
+      } else {
+        std::cerr << "Error getting resource path: " << SDL_GetError() << std::endl;
+        return "";
+      }
+      size_t replacePosition = basePath.rfind("bin");
+      basePath = basePath.substr(0, replacePosition) + "res" + PATH_SEP;;
+    }
+    return directory.empty() ? basePath : basePath + directory + PATH_SEP;
+  }
+  int WindowWidth(void) {
+    return 640;
+  }
+  int WindowHeight(void) {
+    return 480;
+  }
+  int SpriteSize(void) {
+    return 32;
+  }
+  int BenchmarkFrames(void) {
+    return 20;
+  }
+}
@@ -0,0 +1,15 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include <string>
+
+namespace Constants {
+  extern char const * const ApplicationName(void);
+  extern std::string ResourcePath(const std::string &subDir);
+  extern int WindowWidth(void);
+  extern int WindowHeight(void);
+  extern int SpriteSize(void);
+  extern int BenchmarkFrames(void);
+};
+
+#endif // CONSTANTS_H
@@ -0,0 +1,114 @@
+#include "LessonHelpers.h"
+
+#include <iostream>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "SpriteBatch.h"
+
+void logSdlError(std::ostream &pOutputStream, const std::string pMessage) {
+  pOutputStream << pMessage << " Error: " << SDL_GetError() << std::endl;
+}
+
+SDL_Texture *loadBmpTexture(const std::string &pFileName, SDL_Renderer *pRenderer) {
+  SDL_Texture *texture = nullptr;
+  SDL_Surface *loadedImage = SDL_LoadBMP(pFileName.c_str());
+  if (nullptr == loadedImage) {
+    logSdlError(std::cerr, "LoadBMP");
+  } else {
+    texture = SDL_CreateTextureFromSurface(pRenderer, loadedImage);
+    SDL_FreeSurface(loadedImage);
+    if (nullptr == texture) {
+      logSdlError(std::cerr, "CreateTextureFromSurface");
+    }
+  }
+  return texture;
+}
+
+SDL_Texture *loadTexture(const std::string &pFileName, SDL_Renderer *pRenderer) {
+  SDL_Texture *texture = IMG_LoadTexture(pRenderer, pFileName.c_str());
+  if (nullptr == texture) {
+    logSdlError(std::cerr, "LoadTexture");
+  }
+  return texture;
+}
+
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, SDL_Rect pDestination, SDL_Rect *pClip) {
+  SpriteBatch *batch = SpriteBatch::current(pRenderer);
+  if (nullptr == batch) {
+    SDL_RenderCopy(pRenderer, pTexture, pClip, &pDestination);
+  } else {
+    batch->draw(pTexture, pDestination, pClip);
+  }
+}
+
+void renderTexture(
+  SDL_Texture *pTexture,
+  SDL_Renderer *pRenderer,
+  int pPositionX,
+  int pPositionY,
+  int pWidth,
+  int pHeight,
+  SDL_Rect *pClip
+) {
+  SDL_Rect destination;
+  destination.x = pPositionX;
+  destination.y = pPositionY;
+  destination.w = pWidth;
+  destination.h = pHeight;
+  renderTexture(pTexture, pRenderer, destination, pClip);
+}
+
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPositionX, int pPositionY, SDL_Rect *pClip) {
+  SDL_Rect destination;
+  destination.x = pPositionX;
+  destination.y = pPositionY;
+  if (nullptr == pClip) {
+    SDL_QueryTexture(pTexture, nullptr, nullptr, &destination.w, &destination.h);
+  } else {
+    destination.w = pClip->w;
+    destination.h = pClip->h;
+  }
+  renderTexture(pTexture, pRenderer, destination, pClip);
+}
+
+SDL_Texture *renderText(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  SDL_Color pColor,
+  SDL_Renderer *pRenderer
+) {
+  SDL_Surface *surface = TTF_RenderText_Blended(pFont, pMessage.c_str(), pColor);
+  if (nullptr == surface) {
+    logSdlError(std::cerr, "TTF_RenderText");
+    return nullptr;
+  }
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(pRenderer, surface);
+  if (nullptr == texture) {
+    logSdlError(std::cerr, "CreateTexture");
+  }
+  SDL_FreeSurface(surface);
+  return texture;
+}
+
+bool renderText(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  SDL_Color pColor,
+  GlyphCache &pGlyphs,
+  SurfacePool &pPool,
+  DynamicTexture &pTexture
+) {
+  SDL_Surface *surface = pGlyphs.render(pMessage, pFont, pColor, pPool);
+  if (nullptr == surface) {
+    logSdlError(std::cerr, "GlyphCache");
+    return false;
+  }
+  bool updated = pTexture.update(surface, surface->clip_rect.w, surface->clip_rect.h);
+  if (!updated) {
+    logSdlError(std::cerr, "DynamicTexture");
+  }
+  pPool.release(surface);
+  return updated;
+}
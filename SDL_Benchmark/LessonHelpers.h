@@ -0,0 +1,56 @@
+#ifndef LESSON_HELPERS_H
+#define LESSON_HELPERS_H
+
+#include <ostream>
+#include <string>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "DynamicTexture.h"
+#include "GlyphCache.h"
+#include "SurfacePool.h"
+
+/*
+ * The loading and drawing helpers from the lesson mains, gathered in one
+ * translation unit so the microbenchmarks can call them.  Keep them in step
+ * with SDL_Lesson2 (loadBmpTexture) and SDL_Lesson6 (everything else).
+ * Errors go to std::cerr so stdout stays valid JSON.
+ */
+
+void logSdlError(std::ostream &pOutputStream, const std::string pMessage);
+
+// SDL_Lesson2: SDL_LoadBMP + SDL_CreateTextureFromSurface.
+SDL_Texture *loadBmpTexture(const std::string &pFileName, SDL_Renderer *pRenderer);
+// SDL_Lesson3 onwards: IMG_LoadTexture.
+SDL_Texture *loadTexture(const std::string &pFileName, SDL_Renderer *pRenderer);
+
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, SDL_Rect pDestination, SDL_Rect *pClip = nullptr);
+void renderTexture(
+  SDL_Texture *pTexture,
+  SDL_Renderer *pRenderer,
+  int pPositionX,
+  int pPositionY,
+  int pWidth,
+  int pHeight,
+  SDL_Rect *pClip = nullptr
+);
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPositionX, int pPositionY, SDL_Rect *pClip = nullptr);
+
+// The SDL_ttf path SDL_Lesson6 used before glyph composition.
+SDL_Texture *renderText(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  SDL_Color pColor,
+  SDL_Renderer *pRenderer
+);
+// SDL_Lesson6: GlyphCache composition streamed into a DynamicTexture.
+bool renderText(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  SDL_Color pColor,
+  GlyphCache &pGlyphs,
+  SurfacePool &pPool,
+  DynamicTexture &pTexture
+);
+
+#endif // LESSON_HELPERS_H
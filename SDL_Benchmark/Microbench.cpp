@@ -0,0 +1,100 @@
+#include "Microbench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <SDL2/SDL.h>
+
+namespace {
+  double percentile(const std::vector<double> &pSorted, double pFraction) {
+    size_t rank = (size_t)(pFraction * pSorted.size() + 0.5);
+    return pSorted[std::min(std::max<size_t>(rank, 1), pSorted.size()) - 1];
+  }
+}
+
+Microbench::Microbench(int pWarmup, int pRepetitions, const std::string &pFilter) :
+  mWarmup(std::max(0, pWarmup)),
+  mRepetitions(std::max(1, pRepetitions)),
+  mFilter(pFilter)
+{
+}
+
+void Microbench::record(const std::string &pName, int pIterations, std::vector<double> &pSamples) {
+  std::sort(pSamples.begin(), pSamples.end());
+  double sum = 0.0;
+  for (double sample : pSamples) {
+    sum += sample;
+  }
+  double mean = sum / pSamples.size();
+  double squares = 0.0;
+  for (double sample : pSamples) {
+    squares += (sample - mean) * (sample - mean);
+  }
+  Result result;
+  result.name = pName;
+  result.iterations = pIterations;
+  result.repetitions = pSamples.size();
+  result.mean = mean;
+  result.stddev = 1 < pSamples.size() ? std::sqrt(squares / (pSamples.size() - 1)) : 0.0;
+  result.min = pSamples.front();
+  result.median = percentile(pSamples, 0.50);
+  result.p95 = percentile(pSamples, 0.95);
+  result.max = pSamples.back();
+  mResults.push_back(result);
+}
+
+bool Microbench::check(const std::string &pName, int pMaxError, int pTolerance) {
+  if (!mFilter.empty() && std::string::npos == pName.find(mFilter)) {
+    return true;
+  }
+  Check check = {pName, pMaxError, pTolerance};
+  mChecks.push_back(check);
+  return pMaxError <= pTolerance;
+}
+
+bool Microbench::passed(void) const {
+  for (const Check &check : mChecks) {
+    if (check.tolerance < check.maxError) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::vector<Microbench::Result> &Microbench::results(void) const {
+  return mResults;
+}
+
+void Microbench::writeJson(std::ostream &pOutputStream, const char *pSuite) const {
+  SDL_version version;
+  SDL_GetVersion(&version);
+  pOutputStream << std::fixed << std::setprecision(1)
+    << "{\n  \"suite\": \"" << pSuite << "\",\n"
+    << "  \"sdl\": \"" << (int)version.major << "." << (int)version.minor << "." << (int)version.patch << "\",\n"
+    << "  \"warmup\": " << mWarmup << ",\n"
+    << "  \"unit\": \"ns/op\",\n"
+    << "  \"results\": [";
+  for (size_t i = 0; i < mResults.size(); i++) {
+    const Result &result = mResults[i];
+    pOutputStream << (0 == i ? "\n" : ",\n")
+      << "    {\"name\": \"" << result.name << "\""
+      << ", \"iterations\": " << result.iterations
+      << ", \"repetitions\": " << result.repetitions
+      << ", \"mean\": " << result.mean
+      << ", \"stddev\": " << result.stddev
+      << ", \"min\": " << result.min
+      << ", \"median\": " << result.median
+      << ", \"p95\": " << result.p95
+      << ", \"max\": " << result.max << "}";
+  }
+  pOutputStream << "\n  ],\n  \"checks\": [";
+  for (size_t i = 0; i < mChecks.size(); i++) {
+    const Check &check = mChecks[i];
+    pOutputStream << (0 == i ? "\n" : ",\n")
+      << "    {\"name\": \"" << check.name << "\""
+      << ", \"maxError\": " << check.maxError
+      << ", \"tolerance\": " << check.tolerance
+      << ", \"passed\": " << (check.maxError <= check.tolerance ? "true" : "false") << "}";
+  }
+  pOutputStream << "\n  ]\n}" << std::endl;
+}
@@ -0,0 +1,80 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * Minimal microbenchmark harness.  Each case runs a number of discarded
+ * warmup repetitions, then timed repetitions of a fixed iteration count;
+ * the summary is over the per-repetition nanoseconds per iteration.
+ * Accuracy checks are reported alongside the timings.
+ */
+class Microbench {
+  public:
+    struct Result {
+      std::string name;
+      int iterations;
+      int repetitions;
+      double mean;
+      double stddev;
+      double min;
+      double median;
+      double p95;
+      double max;
+    };
+
+    struct Check {
+      std::string name;
+      int maxError;
+      int tolerance;
+    };
+
+    Microbench(int pWarmup, int pRepetitions, const std::string &pFilter = "");
+
+    // Times pBody(pIterations) per repetition.  The body runs the iterations
+    // itself so it can flush or tidy up once per repetition.
+    template<typename Body>
+    void run(const std::string &pName, int pIterations, Body pBody);
+
+    // Records an accuracy check: pMaxError is the largest per-channel
+    // difference from the reference, which must not exceed pTolerance.
+    bool check(const std::string &pName, int pMaxError, int pTolerance);
+    // True if every check so far was within tolerance.
+    bool passed(void) const;
+
+    const std::vector<Result> &results(void) const;
+    void writeJson(std::ostream &pOutputStream, const char *pSuite) const;
+
+  private:
+    void record(const std::string &pName, int pIterations, std::vector<double> &pSamples);
+
+    int mWarmup;
+    int mRepetitions;
+    std::string mFilter;
+    std::vector<Result> mResults;
+    std::vector<Check> mChecks;
+};
+
+template<typename Body>
+void Microbench::run(const std::string &pName, int pIterations, Body pBody) {
+  if (!mFilter.empty() && std::string::npos == pName.find(mFilter)) {
+    return;
+  }
+  const double frequency = SDL_GetPerformanceFrequency();
+  std::vector<double> samples;
+  samples.reserve(mRepetitions);
+  for (int repetition = -mWarmup; repetition < mRepetitions; repetition++) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    pBody(pIterations);
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    if (0 <= repetition) {
+      samples.push_back(1e9 * elapsed / frequency / pIterations);
+    }
+  }
+  record(pName, pIterations, samples);
+}
+
+#endif // MICROBENCH_H
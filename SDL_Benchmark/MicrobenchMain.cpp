@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "Animator.h"
+#include "Constants.h"
+#include "DynamicTexture.h"
+#include "GlyphCache.h"
+#include "LessonHelpers.h"
+#include "Microbench.h"
+#include "PerformanceOverlay.h"
+#include "SoftwareBlitter.h"
+#include "SurfacePool.h"
+#include "TileRasterizer.h"
+#include "Utility.h"
+
+/*
+ * Microbenchmarks for the lesson helpers: the three renderTexture overloads,
+ * loadTexture on the BMP and PNG paths, renderText through SDL_ttf and
+ * through GlyphCache into a DynamicTexture, PerformanceOverlay::draw,
+ * Constants::ResourcePath, Animator against per-property libm calls,
+ * each SoftwareBlitter level against SDL's surface blitter, and
+ * TileRasterizer from one thread up to --threads (default: every CPU) on a
+ * full-HD tile-plus-sprite frame.  Results are written as JSON so runs can be
+ * compared across commits; the exit status is non-zero if a blitter level
+ * differs from the scalar kernels or from SDL beyond the checked tolerance,
+ * or if a warm SurfacePool allocates surfaces or a warm DynamicTexture
+ * creates textures.
+ *
+ * This is the SDL_Microbench driver; the harness it runs the cases with is
+ * Microbench.{h,cpp}.
+ *
+ * Usage: SDL_Microbench [--warmup N] [--repetitions N] [--filter TEXT] [--output FILE]
+ *                       [--threads N]
+ */
+
+namespace {
+  const int DEFAULT_WARMUP = 3;
+  const int DEFAULT_REPETITIONS = 15;
+  const int DRAWS = 1000;
+  const int LOADS = 20;
+  const int TEXTS = 100;
+  const int LOOKUPS = 10000;
+  const int ANIMATED = 10000;
+  const int UPDATES = 100;
+  const int BLITS = 1000;
+  const int FILLS = 100;
+  const int BLIT_SIZE = 64;
+  const int SCALED_WIDTH = 96;
+  const int SCALED_HEIGHT = 80;
+  const int SCALING_WIDTH = 1920;
+  const int SCALING_HEIGHT = 1080;
+  const int SCALING_SPRITES = 500;
+  const int SCALING_FRAMES = 10;
+  // SDL's blend divides by 256 rather than 255 on some paths.
+  const int SDL_BLEND_TOLERANCE = 3;
+
+  // Deterministic noise, alpha included, so every blend weight is covered.
+  void fillNoise(SDL_Surface *pSurface, Uint32 pSeed) {
+    Uint32 state = pSeed;
+    for (int y = 0; y < pSurface->h; y++) {
+      Uint32 *row = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(pSurface->pixels) + y * pSurface->pitch);
+      for (int x = 0; x < pSurface->w; x++) {
+        state = state * 1664525 + 1013904223;
+        row[x] = state;
+      }
+    }
+  }
+
+  int maxChannelError(const SDL_Surface *pFirst, const SDL_Surface *pSecond) {
+    int error = 0;
+    for (int y = 0; y < pFirst->h; y++) {
+      const Uint8 *first = static_cast<const Uint8 *>(pFirst->pixels) + y * pFirst->pitch;
+      const Uint8 *second = static_cast<const Uint8 *>(pSecond->pixels) + y * pSecond->pitch;
+      for (int x = 0; x < 4 * pFirst->w; x++) {
+        error = std::max(error, std::abs(first[x] - second[x]));
+      }
+    }
+    return error;
+  }
+}
+
+int main(int argc, char** argv) {
+  int warmup = DEFAULT_WARMUP;
+  int repetitions = DEFAULT_REPETITIONS;
+  std::string filter;
+  std::string outputPath;
+  int maxThreads = std::max(1, SDL_GetCPUCount());
+  for (int i = 1; i < argc; i++) {
+    if (0 == strcmp("--warmup", argv[i]) && i + 1 < argc) {
+      warmup = atoi(argv[++i]);
+    } else if (0 == strcmp("--repetitions", argv[i]) && i + 1 < argc) {
+      repetitions = atoi(argv[++i]);
+    } else if (0 == strcmp("--filter", argv[i]) && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (0 == strcmp("--output", argv[i]) && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (0 == strcmp("--threads", argv[i]) && i + 1 < argc) {
+      maxThreads = std::max(1, atoi(argv[++i]));
+    } else {
+      std::cerr << "Usage: SDL_Microbench [--warmup N] [--repetitions N] [--filter TEXT] [--output FILE] [--threads N]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (0 != SDL_Init(0)) {
+    std::cerr << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (IMG_INIT_PNG != (IMG_INIT_PNG & IMG_Init(IMG_INIT_PNG))) {
+    logSdlError(std::cerr, "IMG_Init");
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  if (0 != TTF_Init()) {
+    logSdlError(std::cerr, "TTF_Init");
+    IMG_Quit();
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  SDL_Surface *framebuffer = SDL_CreateRGBSurfaceWithFormat(
+    0,
+    Constants::WindowWidth(),
+    Constants::WindowHeight(),
+    32,
+    SDL_PIXELFORMAT_ARGB8888
+  );
+  SDL_Renderer *renderer = nullptr == framebuffer ? nullptr : SDL_CreateSoftwareRenderer(framebuffer);
+  if (nullptr == renderer) {
+    logSdlError(std::cerr, "SDL_CreateSoftwareRenderer");
+    Utility::cleanup(framebuffer);
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+
+  const std::string bmpPath = Constants::ResourcePath("SDL_Lesson2") + "image.bmp";
+  const std::string pngPath = Constants::ResourcePath("SDL_Lesson3") + "image.png";
+  const std::string fontPath = Constants::ResourcePath("SDL_Lesson6") + "twinklebear_ascii.ttf";
+  SDL_Texture *sprite = loadTexture(pngPath, renderer);
+  TTF_Font *font = TTF_OpenFont(fontPath.c_str(), 32);
+  if (nullptr == sprite || nullptr == font) {
+    logSdlError(std::cerr, nullptr == font ? "TTF_OpenFont" : "LoadTexture");
+    if (nullptr != font) {
+      TTF_CloseFont(font);
+    }
+    Utility::cleanup(sprite, renderer, framebuffer);
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  int spriteWidth, spriteHeight;
+  SDL_QueryTexture(sprite, nullptr, nullptr, &spriteWidth, &spriteHeight);
+  int maxX = std::max(1, Constants::WindowWidth() - spriteWidth);
+  int maxY = std::max(1, Constants::WindowHeight() - spriteHeight);
+
+  Microbench bench(warmup, repetitions, filter);
+  // Draws are flushed once per repetition so rasterisation is included.
+  bench.run("renderTexture(SDL_Rect)", DRAWS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      SDL_Rect destination = {i * 7 % maxX, i * 13 % maxY, spriteWidth, spriteHeight};
+      renderTexture(sprite, renderer, destination);
+    }
+    SDL_RenderFlush(renderer);
+  });
+  bench.run("renderTexture(x,y,w,h)", DRAWS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      renderTexture(sprite, renderer, i * 7 % maxX, i * 13 % maxY, spriteWidth, spriteHeight);
+    }
+    SDL_RenderFlush(renderer);
+  });
+  bench.run("renderTexture(x,y)", DRAWS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      renderTexture(sprite, renderer, i * 7 % maxX, i * 13 % maxY);
+    }
+    SDL_RenderFlush(renderer);
+  });
+  bench.run("loadTexture(bmp)", LOADS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      Utility::cleanup(loadBmpTexture(bmpPath, renderer));
+    }
+  });
+  bench.run("loadTexture(png)", LOADS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      Utility::cleanup(loadTexture(pngPath, renderer));
+    }
+  });
+  const SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+  bench.run("renderText", TEXTS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      Utility::cleanup(renderText("True type font test!", font, white, renderer));
+    }
+  });
+  GlyphCache glyphs(renderer);
+  SurfacePool pool;
+  DynamicTexture counter(renderer);
+  // A changing counter, as a HUD draws it, streamed into one texture.
+  auto counterText = [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      renderText("Frame: " + std::to_string(i * 37), font, white, glyphs, pool, counter);
+    }
+  };
+  bench.run("renderText(dynamic)", TEXTS, counterText);
+  // Once the pool and the texture have seen each size, composing and
+  // uploading the text allocates no surfaces and no textures.
+  counterText(TEXTS);
+  unsigned long warmAllocations = pool.stats().allocations;
+  unsigned long warmCreations = counter.stats().creations;
+  counterText(TEXTS);
+  bench.check("SurfacePool allocations once warm", (int)(pool.stats().allocations - warmAllocations), 0);
+  bench.check("DynamicTexture creations once warm", (int)(counter.stats().creations - warmCreations), 0);
+  // A full graph and five lines of text, as the overlay draws every frame.
+  PerformanceOverlay overlay(renderer, glyphs, font, 60);
+  overlay.setVisible(true);
+  bench.run("PerformanceOverlay::draw", TEXTS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      PerformanceOverlay::Frame frame = {(15 + i % 5) / 1000.0, 12, 4, (size_t)8 << 20};
+      overlay.record(frame);
+      overlay.draw(8, 8);
+    }
+  });
+  volatile size_t sink = 0;
+  bench.run("Constants::ResourcePath", LOOKUPS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      sink = sink + Constants::ResourcePath("SDL_Lesson2").size();
+    }
+  });
+
+  // Four animated properties per object, as in the lessons.
+  std::vector<float> properties(4 * ANIMATED);
+  Animator animator;
+  for (int i = 0; i < ANIMATED; i++) {
+    animator.cosine(&properties[4 * i], 1.0f, 0.5f, 2.0f, i * 0.01f);
+    animator.sine(&properties[4 * i + 1], 1.0f, 0.5f, 2.0f, i * 0.01f);
+    animator.cosine(&properties[4 * i + 2], 1.0f, 0.5f, 0.5f, i * 0.01f);
+    animator.sine(&properties[4 * i + 3], 1.0f, 0.5f, 1.0f, i * 0.01f);
+  }
+  bench.run("Animator::update(10000 objects)", UPDATES, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      animator.update(i / 60.0);
+    }
+  });
+  bench.run("libm cos/sin(10000 objects)", UPDATES, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      double seconds = i / 60.0;
+      for (int j = 0; j < ANIMATED; j++) {
+        double phase = j * 0.01;
+        properties[4 * j] = 1.0 + 0.5 * cos(seconds * 2 + phase);
+        properties[4 * j + 1] = 1.0 + 0.5 * sin(seconds * 2 + phase);
+        properties[4 * j + 2] = 1.0 + 0.5 * cos(seconds / 2 + phase);
+        properties[4 * j + 3] = 1.0 + 0.5 * sin(seconds + phase);
+      }
+    }
+  });
+
+  // SoftwareBlitter: every level the CPU supports, then SDL's own blitter.
+  // Each kind of draw renders one reference scene per level, compared with
+  // the scalar kernels (bit-exact) or with SDL (within its rounding).
+  SDL_Surface *blitSource = SDL_CreateRGBSurfaceWithFormat(0, BLIT_SIZE, BLIT_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_Surface *backdrop = SDL_CreateRGBSurfaceWithFormat(0, Constants::WindowWidth(), Constants::WindowHeight(), 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_Surface *reference = SDL_CreateRGBSurfaceWithFormat(0, Constants::WindowWidth(), Constants::WindowHeight(), 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, Constants::WindowWidth(), Constants::WindowHeight(), 32, SDL_PIXELFORMAT_ARGB8888);
+  if (nullptr == blitSource || nullptr == backdrop || nullptr == reference || nullptr == target) {
+    logSdlError(std::cerr, "SDL_CreateRGBSurfaceWithFormat");
+    Utility::cleanup(blitSource, backdrop, reference, target);
+    counter.clear();
+    glyphs.clear();
+    TTF_CloseFont(font);
+    Utility::cleanup(sprite, renderer, framebuffer);
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  fillNoise(blitSource, 1);
+  fillNoise(backdrop, 2);
+  SDL_SetSurfaceBlendMode(backdrop, SDL_BLENDMODE_NONE);
+  SDL_SetSurfaceBlendMode(blitSource, SDL_BLENDMODE_BLEND);
+  int blitMaxX = Constants::WindowWidth() - SCALED_WIDTH;
+  int blitMaxY = Constants::WindowHeight() - SCALED_HEIGHT;
+  const Uint32 fillColor = 0xFF336699;
+  const char *blitKinds[] = {"blend", "nearest", "bilinear", "fill"};
+  // Draws kind pKind across pSurface, including rects clipped by its edges.
+  auto blitScene = [&](SoftwareBlitter &pBlitter, int pKind, SDL_Surface *pSurface) {
+    SDL_BlitSurface(backdrop, nullptr, pSurface, nullptr);
+    for (int i = 0; i < 50; i++) {
+      SDL_Rect destination = {i * 37 % (blitMaxX + 40) - 20, i * 53 % (blitMaxY + 40) - 20, BLIT_SIZE, BLIT_SIZE};
+      if (0 == pKind) {
+        pBlitter.blit(blitSource, nullptr, pSurface, &destination);
+      } else if (3 == pKind) {
+        pBlitter.fill(pSurface, &destination, fillColor);
+      } else {
+        destination.w = SCALED_WIDTH - i % 3 * 40;
+        destination.h = SCALED_HEIGHT - i % 5 * 12;
+        pBlitter.blit(blitSource, nullptr, pSurface, &destination, 1 == pKind ? ScaleFilter::Nearest : ScaleFilter::Bilinear);
+      }
+    }
+  };
+  SoftwareBlitter blitter;
+  for (int kind = 0; kind < 4; kind++) {
+    blitter.setLevel(BlitLevel::Scalar);
+    blitScene(blitter, kind, reference);
+    for (BlitLevel level : {BlitLevel::SSE2, BlitLevel::AVX2}) {
+      if (blitter.setLevel(level)) {
+        blitScene(blitter, kind, target);
+        bench.check(
+          std::string("SoftwareBlitter(") + blitKinds[kind] + "," + SoftwareBlitter::name(level) + ") vs scalar",
+          maxChannelError(reference, target),
+          0
+        );
+      }
+    }
+  }
+  {
+    // Same scenes through SDL; the scaled filters have no SDL equivalent
+    // with the same sampling, so only blend and fill are compared.
+    blitter.setLevel(SoftwareBlitter::detect());
+    blitScene(blitter, 0, reference);
+    SDL_BlitSurface(backdrop, nullptr, target, nullptr);
+    for (int i = 0; i < 50; i++) {
+      SDL_Rect destination = {i * 37 % (blitMaxX + 40) - 20, i * 53 % (blitMaxY + 40) - 20, BLIT_SIZE, BLIT_SIZE};
+      SDL_BlitSurface(blitSource, nullptr, target, &destination);
+    }
+    bench.check("SoftwareBlitter(blend) vs SDL_BlitSurface", maxChannelError(reference, target), SDL_BLEND_TOLERANCE);
+    blitScene(blitter, 3, reference);
+    SDL_BlitSurface(backdrop, nullptr, target, nullptr);
+    for (int i = 0; i < 50; i++) {
+      SDL_Rect destination = {i * 37 % (blitMaxX + 40) - 20, i * 53 % (blitMaxY + 40) - 20, BLIT_SIZE, BLIT_SIZE};
+      SDL_FillRect(target, &destination, fillColor);
+    }
+    bench.check("SoftwareBlitter(fill) vs SDL_FillRect", maxChannelError(reference, target), 0);
+  }
+  for (BlitLevel level : {BlitLevel::Scalar, BlitLevel::SSE2, BlitLevel::AVX2}) {
+    if (!blitter.setLevel(level)) {
+      continue;
+    }
+    const std::string suffix = std::string(",") + SoftwareBlitter::name(level) + ")";
+    bench.run("SoftwareBlitter::blit(blend" + suffix, BLITS, [&](int pIterations) {
+      for (int i = 0; i < pIterations; i++) {
+        SDL_Rect destination = {i * 7 % blitMaxX, i * 13 % blitMaxY, BLIT_SIZE, BLIT_SIZE};
+        blitter.blit(blitSource, nullptr, target, &destination);
+      }
+    });
+    bench.run("SoftwareBlitter::blit(nearest" + suffix, BLITS, [&](int pIterations) {
+      for (int i = 0; i < pIterations; i++) {
+        SDL_Rect destination = {i * 7 % blitMaxX, i * 13 % blitMaxY, SCALED_WIDTH, SCALED_HEIGHT};
+        blitter.blit(blitSource, nullptr, target, &destination, ScaleFilter::Nearest);
+      }
+    });
+    bench.run("SoftwareBlitter::blit(bilinear" + suffix, BLITS, [&](int pIterations) {
+      for (int i = 0; i < pIterations; i++) {
+        SDL_Rect destination = {i * 7 % blitMaxX, i * 13 % blitMaxY, SCALED_WIDTH, SCALED_HEIGHT};
+        blitter.blit(blitSource, nullptr, target, &destination, ScaleFilter::Bilinear);
+      }
+    });
+    bench.run("SoftwareBlitter::fill(window" + suffix, FILLS, [&](int pIterations) {
+      for (int i = 0; i < pIterations; i++) {
+        blitter.fill(target, nullptr, fillColor + i);
+      }
+    });
+  }
+  bench.run("SDL_BlitSurface(blend)", BLITS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      SDL_Rect destination = {i * 7 % blitMaxX, i * 13 % blitMaxY, BLIT_SIZE, BLIT_SIZE};
+      SDL_BlitSurface(blitSource, nullptr, target, &destination);
+    }
+  });
+  bench.run("SDL_BlitScaled(nearest)", BLITS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      SDL_Rect destination = {i * 7 % blitMaxX, i * 13 % blitMaxY, SCALED_WIDTH, SCALED_HEIGHT};
+      SDL_BlitScaled(blitSource, nullptr, target, &destination);
+    }
+  });
+  bench.run("SDL_FillRect(window)", FILLS, [&](int pIterations) {
+    for (int i = 0; i < pIterations; i++) {
+      SDL_FillRect(target, nullptr, fillColor + i);
+    }
+  });
+
+  // TileRasterizer scaling: a scrolling tile background plus blended and
+  // scaled sprites, as in SDL_Lesson4-6, rendered from 1 to maxThreads.
+  SDL_Surface *scalingReference = SDL_CreateRGBSurfaceWithFormat(0, SCALING_WIDTH, SCALING_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_Surface *scalingTarget = SDL_CreateRGBSurfaceWithFormat(0, SCALING_WIDTH, SCALING_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+  if (nullptr == scalingReference || nullptr == scalingTarget) {
+    logSdlError(std::cerr, "SDL_CreateRGBSurfaceWithFormat");
+  } else {
+    // Issues one frame's draws through pDraw(source rect, destination,
+    // filter, blend) after pFill clears the frame.
+    auto scalingScene = [&](int pFrame, std::function<void(const SDL_Rect &, const SDL_Rect &, ScaleFilter, bool)> pDraw, std::function<void(Uint32)> pFill) {
+      pFill(0xFF000066);
+      int offset = pFrame * 3 % BLIT_SIZE;
+      for (int y = -offset; y < SCALING_HEIGHT; y += BLIT_SIZE) {
+        for (int x = -offset; x < SCALING_WIDTH; x += BLIT_SIZE) {
+          pDraw({0, 0, BLIT_SIZE, BLIT_SIZE}, {x, y, BLIT_SIZE, BLIT_SIZE}, ScaleFilter::Nearest, false);
+        }
+      }
+      for (int i = 0; i < SCALING_SPRITES; i++) {
+        SDL_Rect clip = {i % 16, i % 8, BLIT_SIZE - 16, BLIT_SIZE - 8};
+        SDL_Rect destination = {
+          (i * 97 + pFrame * 5) % SCALING_WIDTH - BLIT_SIZE,
+          (i * 61 + pFrame * 3) % SCALING_HEIGHT - BLIT_SIZE,
+          BLIT_SIZE + i % 4 * 24,
+          BLIT_SIZE + i % 3 * 24
+        };
+        pDraw(clip, destination, i % 2 ? ScaleFilter::Bilinear : ScaleFilter::Nearest, true);
+      }
+    };
+    SoftwareBlitter direct;
+    auto directFrame = [&](int pFrame, SDL_Surface *pSurface) {
+      scalingScene(pFrame, [&](const SDL_Rect &pClip, const SDL_Rect &pDestination, ScaleFilter pFilter, bool pBlend) {
+        direct.blit(blitSource, &pClip, pSurface, &pDestination, pFilter, pBlend);
+      }, [&](Uint32 pColor) {
+        direct.fill(pSurface, nullptr, pColor);
+      });
+    };
+    auto tiledFrame = [&](int pFrame, TileRasterizer &pTiles, SDL_Surface *pSurface) {
+      scalingScene(pFrame, [&](const SDL_Rect &pClip, const SDL_Rect &pDestination, ScaleFilter pFilter, bool pBlend) {
+        pTiles.draw(blitSource, &pClip, pDestination, pFilter, pBlend);
+      }, [&](Uint32 pColor) {
+        pTiles.fill(nullptr, pColor);
+      });
+      pTiles.render(pSurface);
+    };
+    directFrame(0, scalingReference);
+    const std::string resolution = std::to_string(SCALING_WIDTH) + "x" + std::to_string(SCALING_HEIGHT);
+    bench.run("SoftwareBlitter(" + resolution + ",direct)", SCALING_FRAMES, [&](int pIterations) {
+      for (int i = 0; i < pIterations; i++) {
+        directFrame(i, scalingTarget);
+      }
+    });
+    for (int threads = 1; threads <= maxThreads; threads++) {
+      TileRasterizer tiles(threads);
+      const std::string label = "TileRasterizer(" + resolution + "," + std::to_string(threads) + " threads)";
+      tiledFrame(0, tiles, scalingTarget);
+      bench.check(label + " vs SoftwareBlitter", maxChannelError(scalingReference, scalingTarget), 0);
+      bench.run(label, SCALING_FRAMES, [&](int pIterations) {
+        for (int i = 0; i < pIterations; i++) {
+          tiledFrame(i, tiles, scalingTarget);
+        }
+      });
+    }
+  }
+  Utility::cleanup(scalingReference, scalingTarget);
+  Utility::cleanup(blitSource, backdrop, reference, target);
+
+  if (outputPath.empty()) {
+    bench.writeJson(std::cout, "SDL_Microbench");
+  } else {
+    std::ofstream output(outputPath.c_str());
+    bench.writeJson(output, "SDL_Microbench");
+    if (!output) {
+      std::cerr << "Error: could not write " << outputPath << std::endl;
+    }
+  }
+
+  counter.clear();
+  glyphs.clear();
+  TTF_CloseFont(font);
+  Utility::cleanup(sprite, renderer, framebuffer);
+  TTF_Quit();
+  IMG_Quit();
+  SDL_Quit();
+  if (!bench.passed()) {
+    std::cerr << "Error: a microbenchmark check is outside tolerance" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
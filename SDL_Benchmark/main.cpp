@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "Constants.h"
+#include "SpriteBatch.h"
+#include "Utility.h"
+
+/*
+ * Benchmark: draw calls and frame time for immediate SDL_RenderCopy
+ * versus SpriteBatch, on a headless software renderer.
+ */
+
+void logSdlError(std::ostream &pOutputStream, const std::string pMessage) {
+  pOutputStream << pMessage << " Error: " << SDL_GetError() << std::endl;
+}
+
+SDL_Texture *createSpriteTexture(SDL_Renderer *pRenderer) {
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+    0,
+    Constants::SpriteSize(),
+    Constants::SpriteSize(),
+    32,
+    SDL_PIXELFORMAT_ARGB8888
+  );
+  if (nullptr == surface) {
+    logSdlError(std::cout, "SDL_CreateRGBSurfaceWithFormat");
+    return nullptr;
+  }
+  SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 0xFF, 0x80, 0x00, 0xC0));
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(pRenderer, surface);
+  Utility::cleanup(surface);
+  if (nullptr == texture) {
+    logSdlError(std::cout, "SDL_CreateTextureFromSurface");
+  } else {
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  }
+  return texture;
+}
+
+std::vector<SDL_Rect> scatterSprites(int pCount) {
+  std::vector<SDL_Rect> result(pCount);
+  Uint32 seed = 12345;
+  for (SDL_Rect &sprite : result) {
+    seed = seed * 1664525 + 1013904223;
+    sprite.x = (seed >> 8) % (Constants::WindowWidth() - Constants::SpriteSize());
+    seed = seed * 1664525 + 1013904223;
+    sprite.y = (seed >> 8) % (Constants::WindowHeight() - Constants::SpriteSize());
+    sprite.w = Constants::SpriteSize();
+    sprite.h = Constants::SpriteSize();
+  }
+  return result;
+}
+
+double runSpriteFrames(
+  SDL_Renderer *pRenderer,
+  SDL_Texture *pTexture,
+  const std::vector<SDL_Rect> &pSprites,
+  SpriteBatch *pBatch,
+  int pFrames,
+  int &pDrawCalls
+) {
+  Uint64 start = SDL_GetPerformanceCounter();
+  pDrawCalls = 0;
+  for (int frame = 0; frame < pFrames; frame++) {
+    SDL_RenderClear(pRenderer);
+    if (nullptr == pBatch) {
+      for (const SDL_Rect &sprite : pSprites) {
+        SDL_RenderCopy(pRenderer, pTexture, nullptr, &sprite);
+      }
+      pDrawCalls += pSprites.size();
+    } else {
+      pBatch->resetStats();
+      pBatch->begin();
+      for (const SDL_Rect &sprite : pSprites) {
+        pBatch->draw(pTexture, sprite);
+      }
+      pBatch->end();
+      pDrawCalls += pBatch->drawCalls();
+    }
+    SDL_RenderPresent(pRenderer);
+  }
+  Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+  pDrawCalls /= pFrames;
+  return 1000.0 * elapsed / SDL_GetPerformanceFrequency() / pFrames;
+}
+
+int main(int argc, char** argv) {
+  int frames = Constants::BenchmarkFrames();
+  for (int i = 1; i < argc; i++) {
+    if (0 == strcmp("--frames", argv[i]) && i + 1 < argc) {
+      frames = std::max(1, atoi(argv[++i]));
+    }
+  }
+  if (0 != SDL_Init(0)) {
+    std::cout << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    return EXIT_FAILURE;
+  }
+  SDL_Surface *framebuffer = SDL_CreateRGBSurfaceWithFormat(
+    0,
+    Constants::WindowWidth(),
+    Constants::WindowHeight(),
+    32,
+    SDL_PIXELFORMAT_ARGB8888
+  );
+  if (nullptr == framebuffer) {
+    logSdlError(std::cout, "SDL_CreateRGBSurfaceWithFormat");
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(framebuffer);
+  if (nullptr == renderer) {
+    logSdlError(std::cout, "SDL_CreateSoftwareRenderer");
+    Utility::cleanup(framebuffer);
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  SDL_Texture *texture = createSpriteTexture(renderer);
+  if (nullptr == texture) {
+    Utility::cleanup(renderer, framebuffer);
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  SpriteBatch batch(renderer);
+
+  std::cout << std::setw(8) << "sprites"
+    << std::setw(12) << "mode"
+    << std::setw(14) << "calls/frame"
+    << std::setw(12) << "ms/frame" << std::endl;
+  const int spriteCounts[] = {1000, 10000, 100000};
+  for (int count : spriteCounts) {
+    std::vector<SDL_Rect> sprites = scatterSprites(count);
+    for (int batched = 0; batched < 2; batched++) {
+      int drawCalls = 0;
+      double frameTime = runSpriteFrames(renderer, texture, sprites, batched ? &batch : nullptr, frames, drawCalls);
+      std::cout << std::setw(8) << count
+        << std::setw(12) << (batched ? "batched" : "immediate")
+        << std::setw(14) << drawCalls
+        << std::setw(12) << std::fixed << std::setprecision(3) << frameTime << std::endl;
+    }
+  }
+
+  Utility::cleanup(texture, renderer, framebuffer);
+  SDL_Quit();
+  return EXIT_SUCCESS;
+}
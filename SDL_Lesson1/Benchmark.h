@@ -0,0 +1,63 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "Constants.h"
+#include "FrameProfiler.h"
+#include "LessonOptions.h"
+
+/*
+ * Headless benchmark mode for the lesson binaries.  With --benchmark the
+ * lesson runs on SDL's dummy video driver with a software renderer, no vsync
+ * and no frame pacing, stops after a fixed number of frames and prints one
+ * JSON line of throughput and frame-time statistics.
+ *
+ *   SDL_LessonN [--benchmark] [--frames N] [--size WIDTHxHEIGHT]
+ *               [--config FILE] [--set KEY=VALUE]... [lesson options]
+ *
+ * --frames implies --benchmark; --size also applies to interactive runs.
+ * --config reads a settings file and --set overrides a single setting (see
+ * Constants::Configure); later ones win, and --size wins over both.  Any
+ * other argument must be one of the lesson's own LessonOptions.
+ */
+class Benchmark {
+  public:
+    Benchmark(void);
+
+    // Returns false if the command line is malformed or names an option
+    // pOptions does not support.
+    bool parse(int argc, char **argv, LessonOptions &pOptions);
+    // Resolves pConfig from its defaults, --config, --set and --size, then
+    // selects the headless drivers.  Must be called before SDL_Init.
+    // Returns false, with SDL_GetError set, if a setting is invalid.
+    bool prepare(Constants::Config &pConfig);
+
+    bool enabled(void) const;
+    int frames(void) const;
+    Uint32 windowFlags(Uint32 pInteractiveFlags) const;
+    Uint32 rendererFlags(Uint32 pInteractiveFlags) const;
+
+    void start(void);
+    // Records the frame just presented; true once the run is complete.
+    bool frameDone(void);
+    void report(std::ostream &pOutputStream, const char *pName, const LessonOptions &pOptions, const FrameProfiler &pProfiler) const;
+    static void usage(std::ostream &pOutputStream, const char *pName, const LessonOptions &pOptions);
+
+  private:
+    bool mEnabled;
+    int mFrames;
+    int mWidth;
+    int mHeight;
+    std::string mConfigFile;
+    std::vector<std::string> mSettings;
+    Uint64 mStart;
+    Uint64 mLast;
+    Uint64 mElapsed;
+    std::vector<Uint64> mFrameTicks;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,49 @@
+#ifndef LESSON_OPTIONS_H
+#define LESSON_OPTIONS_H
+
+#include <ostream>
+#include <SDL2/SDL.h>
+
+/*
+ * The rendering options a lesson takes from its command line, alongside the
+ * benchmark ones Benchmark::parse handles.  Each lesson names the options it
+ * implements, and a flag for any other option is rejected as malformed
+ * instead of being silently ignored.
+ *
+ *   --retained    dirty-rectangle redraw (RETAINED)
+ *   --cpu-blit    SIMD software blitting (CPU_BLIT)
+ *   --threads N   implies --cpu-blit and rasterises frames in parallel
+ *                 tiles; 0 uses every CPU (CPU_BLIT)
+ *   --idle        event-driven rendering, which only draws when something
+ *                 changed (IDLE)
+ */
+class LessonOptions {
+  public:
+    static const Uint32 RETAINED = 1 << 0;
+    static const Uint32 CPU_BLIT = 1 << 1;
+    static const Uint32 IDLE = 1 << 2;
+
+    // pSupported is the set of options the lesson implements.
+    explicit LessonOptions(Uint32 pSupported);
+
+    // Parses the option at argv[pIndex], advancing pIndex past its value.
+    // Returns false, leaving pIndex alone, if it is not an option this lesson
+    // supports or its value is malformed.
+    bool parse(int argc, char **argv, int &pIndex);
+
+    bool retained(void) const;
+    bool cpuBlit(void) const;
+    // Rasterising threads for --cpu-blit, resolved to a count.
+    int threads(void) const;
+    bool idle(void) const;
+    void usage(std::ostream &pOutputStream) const;
+
+  private:
+    Uint32 mSupported;
+    bool mRetained;
+    bool mCpuBlit;
+    int mThreads;
+    bool mIdle;
+};
+
+#endif // LESSON_OPTIONS_H
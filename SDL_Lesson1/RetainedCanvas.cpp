@@ -0,0 +1,185 @@
+#include "RetainedCanvas.h"
+
+#include <algorithm>
+#include <SDL2/SDL.h>
+
+#include "Utility.h"
+
+namespace {
+  // Past this many separate regions they collapse into their bounding box,
+  // which is cheaper than redrawing the scene once per region.
+  const size_t MAX_REGIONS = 8;
+}
+
+RetainedCanvas::RetainedCanvas(SDL_Renderer *pRenderer) :
+  mRenderer(pRenderer),
+  mBackbuffer(nullptr),
+  mWidth(0),
+  mHeight(0),
+  mFullyDirty(true),
+  mActive(false),
+  mFrames(0),
+  mRedrawn(0.0)
+{
+}
+
+RetainedCanvas::~RetainedCanvas(void) {
+  clear();
+}
+
+void RetainedCanvas::clear(void) {
+  Utility::cleanup(mBackbuffer);
+  mBackbuffer = nullptr;
+  mPrevious.clear();
+  mCurrent.clear();
+  mDirty.clear();
+  mRegions.clear();
+  mFullyDirty = true;
+}
+
+bool RetainedCanvas::create(int pWidth, int pHeight) {
+  clear();
+  if (!SDL_RenderTargetSupported(mRenderer)) {
+    SDL_SetError("Renderer does not support render targets");
+    return false;
+  }
+  mBackbuffer = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, pWidth, pHeight);
+  if (nullptr == mBackbuffer) {
+    return false;
+  }
+  SDL_SetTextureBlendMode(mBackbuffer, SDL_BLENDMODE_NONE);
+  mWidth = pWidth;
+  mHeight = pHeight;
+  return true;
+}
+
+bool RetainedCanvas::retained(void) const {
+  return nullptr != mBackbuffer;
+}
+
+void RetainedCanvas::track(int pId, const SDL_Rect &pBounds) {
+  if (pId < 0) {
+    return;
+  }
+  if (mCurrent.size() <= (size_t)pId) {
+    Tracked unused = {false, {0, 0, 0, 0}};
+    mCurrent.resize(pId + 1, unused);
+  }
+  mCurrent[pId].used = true;
+  mCurrent[pId].bounds = pBounds;
+}
+
+void RetainedCanvas::invalidate(const SDL_Rect *pArea) {
+  if (nullptr == pArea) {
+    mFullyDirty = true;
+  } else {
+    addDirty(*pArea);
+  }
+}
+
+void RetainedCanvas::addDirty(const SDL_Rect &pArea) {
+  if (SDL_RectEmpty(&pArea)) {
+    return;
+  }
+  // Absorb every region the area overlaps; a union can reach further
+  // regions, so start again after each merge.
+  SDL_Rect area = pArea;
+  for (size_t i = 0; i < mDirty.size();) {
+    if (SDL_HasIntersection(&mDirty[i], &area)) {
+      SDL_UnionRect(&mDirty[i], &area, &area);
+      mDirty[i] = mDirty.back();
+      mDirty.pop_back();
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+  mDirty.push_back(area);
+  if (MAX_REGIONS < mDirty.size()) {
+    for (const SDL_Rect &region : mDirty) {
+      SDL_UnionRect(&region, &area, &area);
+    }
+    mDirty.assign(1, area);
+  }
+}
+
+bool RetainedCanvas::begin(void) {
+  if (nullptr == mBackbuffer) {
+    SDL_RenderClear(mRenderer);
+    return true;
+  }
+
+  // Anything that moved, appeared or disappeared dirties its old and new bounds.
+  size_t count = std::max(mPrevious.size(), mCurrent.size());
+  Tracked unused = {false, {0, 0, 0, 0}};
+  mPrevious.resize(count, unused);
+  mCurrent.resize(count, unused);
+  for (size_t i = 0; i < count; i++) {
+    const Tracked &before = mPrevious[i];
+    const Tracked &after = mCurrent[i];
+    if (before.used != after.used || (after.used && !SDL_RectEquals(&before.bounds, &after.bounds))) {
+      if (before.used) {
+        addDirty(before.bounds);
+      }
+      if (after.used) {
+        addDirty(after.bounds);
+      }
+    }
+  }
+  mPrevious.swap(mCurrent);
+  std::fill(mCurrent.begin(), mCurrent.end(), unused);
+
+  SDL_Rect canvas = {0, 0, mWidth, mHeight};
+  mRegions.clear();
+  if (mFullyDirty) {
+    mRegions.push_back(canvas);
+  } else {
+    for (const SDL_Rect &region : mDirty) {
+      SDL_Rect area;
+      if (SDL_IntersectRect(&region, &canvas, &area)) {
+        mRegions.push_back(area);
+      }
+    }
+  }
+  mDirty.clear();
+  mFullyDirty = false;
+  mFrames++;
+  mActive = !mRegions.empty();
+  if (!mActive) {
+    return false;
+  }
+  for (const SDL_Rect &region : mRegions) {
+    mRedrawn += (double)region.w * region.h / ((double)mWidth * mHeight);
+  }
+  SDL_SetRenderTarget(mRenderer, mBackbuffer);
+  SDL_RenderFillRects(mRenderer, mRegions.data(), (int)mRegions.size());
+  return true;
+}
+
+int RetainedCanvas::regions(void) const {
+  return nullptr == mBackbuffer ? 1 : (int)mRegions.size();
+}
+
+void RetainedCanvas::clipTo(int pRegion) {
+  if (nullptr != mBackbuffer) {
+    SDL_RenderSetClipRect(mRenderer, &mRegions[pRegion]);
+  }
+}
+
+void RetainedCanvas::end(void) {
+  if (nullptr == mBackbuffer) {
+    return;
+  }
+  if (mActive) {
+    SDL_RenderSetClipRect(mRenderer, nullptr);
+    SDL_SetRenderTarget(mRenderer, nullptr);
+    mActive = false;
+  }
+  // The copy writes every pixel of the window, so it counts as a full redraw.
+  SDL_RenderCopy(mRenderer, mBackbuffer, nullptr, nullptr);
+  mRedrawn += 1.0;
+}
+
+double RetainedCanvas::redrawFraction(void) const {
+  return 0 == mFrames ? 0.0 : mRedrawn / mFrames;
+}
@@ -2,34 +2,51 @@
 #include <iostream>
 #include <SDL2/SDL.h>
 
+#include "Benchmark.h"
 #include "Constants.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "LessonOptions.h"
+#include "Logger.h"
+#include "RetainedCanvas.h"
 #include "Utility.h"
 
 int main(int argc, char** argv) {
+  Benchmark benchmark;
+  LessonOptions options(LessonOptions::RETAINED | LessonOptions::IDLE);
+  if (!benchmark.parse(argc, argv, options)) {
+    Benchmark::usage(std::cout, Constants::ApplicationName(), options);
+    return EXIT_FAILURE;
+  }
+  Constants::Config config;
+  if (!benchmark.prepare(config)) {
+    Logger::console().log(LogLevel::Error, "Error: Config %s", SDL_GetError());
+    return EXIT_FAILURE;
+  }
   if (0 != SDL_Init(SDL_INIT_VIDEO)) {
-    std::cout << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_Init %s", SDL_GetError());
     return EXIT_FAILURE;
   }
   SDL_Window *window = SDL_CreateWindow(
     Constants::WindowTitle(),
     Constants::WindowPositionX(),
     Constants::WindowPositionY(),
-    Constants::WindowWidth(),
-    Constants::WindowHeight(),
-    SDL_WINDOW_SHOWN
+    config.windowWidth,
+    config.windowHeight,
+    benchmark.windowFlags(SDL_WINDOW_SHOWN)
   );
   if (nullptr == window) {
-    std::cout << "Error: SDL_CreateWindow " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_CreateWindow %s", SDL_GetError());
     SDL_Quit();
     return EXIT_FAILURE;
   }
   SDL_Renderer *renderer = SDL_CreateRenderer(
     window,
     Constants::DefaultRendererWindow(),
-    SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+    benchmark.rendererFlags(SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
   );
   if (nullptr == renderer) {
-    std::cout << "Error: SDL_CreateRenderer " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_CreateRenderer %s", SDL_GetError());
     Utility::cleanup(window);
     SDL_Quit();
     return EXIT_FAILURE;
@@ -37,7 +54,7 @@ int main(int argc, char** argv) {
   const std::string imagePath = Constants::ResourcePath(Constants::ApplicationName()) + "hello.bmp";
   SDL_Surface *bitmap = SDL_LoadBMP(imagePath.c_str());
   if (nullptr == bitmap) {
-    std::cout << "Error: SDL_LoadBMP " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_LoadBMP %s", SDL_GetError());
     Utility::cleanup(renderer, window);
     SDL_Quit();
     return EXIT_FAILURE;
@@ -45,32 +62,71 @@ int main(int argc, char** argv) {
   SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, bitmap);
   Utility::cleanup(bitmap);
   if (nullptr == texture) {
-    std::cout << "Error: SDL_CreateTextureFromSurface " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_CreateTextureFromSurface %s", SDL_GetError());
     Utility::cleanup(renderer, window);
     SDL_Quit();
     return EXIT_FAILURE;
   }
   bool done = false;
   int frame = 0;
+  FrameScheduler scheduler(config.framesPerSecond, benchmark.enabled() ? FrameMode::Uncapped : FrameMode::Paced);
+  FrameProfiler profiler;
+  // hello.bmp never changes, so in retained mode only the first frame draws.
+  RetainedCanvas canvas(renderer);
+  if (options.retained() && !canvas.create(config.windowWidth, config.windowHeight)) {
+    Logger::console().log(LogLevel::Error, "Error: RetainedCanvas %s", SDL_GetError());
+  }
+  // The image is static, so with --idle only input (or an expose) redraws.
+  scheduler.setEventDriven(options.idle() && !benchmark.enabled());
+  benchmark.start();
   do {
+    scheduler.waitForWork();
+    scheduler.beginFrame();
+    profiler.beginFrame();
     SDL_Event event;
-    SDL_PollEvent(&event);
-    switch (event.type) {
-      case SDL_QUIT:
-      case SDL_KEYDOWN:
-      case SDL_MOUSEBUTTONDOWN:
-        done = true;
-        break;
+    while (SDL_PollEvent(&event)) {
+      scheduler.invalidate();
+      switch (event.type) {
+        case SDL_QUIT:
+        case SDL_KEYDOWN:
+        case SDL_MOUSEBUTTONDOWN:
+          done = true;
+          break;
+      }
     }
-    SDL_RenderClear(renderer);
-    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+    profiler.mark(FramePhase::Events);
+    if (!scheduler.pending()) {
+      scheduler.endFrame();
+      continue;
+    }
+    if (canvas.begin()) {
+      profiler.mark(FramePhase::Clear);
+      for (int region = 0; region < canvas.regions(); region++) {
+        canvas.clipTo(region);
+        SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+      }
+      profiler.mark(FramePhase::Background);
+    }
+    canvas.end();
     SDL_RenderPresent(renderer);
-    if (0 == frame % Constants::FramesPerSecond()) {
-      std::cout << "Frame: " << frame << std::endl;
+    profiler.mark(FramePhase::Present);
+    if (!benchmark.enabled() && 0 == frame % config.framesPerSecond) {
+      Logger::console().log(LogLevel::Info, "Frame: %d", frame);
     }
     frame++;
-    SDL_Delay(Constants::FrameWait());
+    done = benchmark.frameDone() || done;
+    scheduler.endFrame();
   } while (!done);
+  Logger::console().flush();
+  if (canvas.retained() && !benchmark.enabled()) {
+    std::cout << "RetainedCanvas redrew " << 100.0 * canvas.redrawFraction() << "% of the window per frame, including the copy to the window" << std::endl;
+  }
+  canvas.clear();
+  if (benchmark.enabled()) {
+    benchmark.report(std::cout, Constants::ApplicationName(), options, profiler);
+  } else {
+    profiler.report(std::cout);
+  }
   Utility::cleanup(texture, renderer, window);
   SDL_Quit();
   return EXIT_SUCCESS;
@@ -0,0 +1,115 @@
+#include "ResourceManager.h"
+
+#include <iterator>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "Utility.h"
+
+ResourceManager::ResourceManager(SDL_Renderer *pRenderer) :
+  mRenderer(pRenderer),
+  mStats()
+{
+}
+
+TextureHandle ResourceManager::texture(const std::string &pFileName) {
+  std::string key = canonical(pFileName);
+  TextureHandle texture = mTextures[key].lock();
+  if (nullptr != texture) {
+    mStats.hits++;
+    return texture;
+  }
+  mStats.misses++;
+  prune();
+  // The surface is only kept while something else holds it.
+  SurfaceHandle surface = load(key);
+  if (nullptr == surface) {
+    return nullptr;
+  }
+  SDL_Texture *uploaded = SDL_CreateTextureFromSurface(mRenderer, surface.get());
+  if (nullptr == uploaded) {
+    return nullptr;
+  }
+  texture = TextureHandle(uploaded, Utility::Deleter());
+  mTextures[key] = texture;
+  return texture;
+}
+
+SurfaceHandle ResourceManager::surface(const std::string &pFileName) {
+  std::string key = canonical(pFileName);
+  SurfaceHandle surface = mSurfaces[key].lock();
+  if (nullptr != surface) {
+    mStats.hits++;
+    return surface;
+  }
+  mStats.misses++;
+  prune();
+  return load(key);
+}
+
+SurfaceHandle ResourceManager::load(const std::string &pKey) {
+  SurfaceHandle surface = mSurfaces[pKey].lock();
+  if (nullptr != surface) {
+    return surface;
+  }
+  SDL_Surface *loaded = SDL_LoadBMP(pKey.c_str());
+  if (nullptr == loaded) {
+    return nullptr;
+  }
+  surface = SurfaceHandle(loaded, Utility::Deleter());
+  mSurfaces[pKey] = surface;
+  return surface;
+}
+
+void ResourceManager::prune(void) {
+  for (std::map<std::string, std::weak_ptr<SDL_Texture> >::iterator it = mTextures.begin(); mTextures.end() != it;) {
+    it = it->second.expired() ? mTextures.erase(it) : std::next(it);
+  }
+  for (std::map<std::string, std::weak_ptr<SDL_Surface> >::iterator it = mSurfaces.begin(); mSurfaces.end() != it;) {
+    it = it->second.expired() ? mSurfaces.erase(it) : std::next(it);
+  }
+}
+
+int ResourceManager::resident(void) const {
+  int count = 0;
+  for (const std::pair<const std::string, std::weak_ptr<SDL_Texture> > &entry : mTextures) {
+    count += entry.second.expired() ? 0 : 1;
+  }
+  for (const std::pair<const std::string, std::weak_ptr<SDL_Surface> > &entry : mSurfaces) {
+    count += entry.second.expired() ? 0 : 1;
+  }
+  return count;
+}
+
+const ResourceManager::Stats &ResourceManager::stats(void) const {
+  return mStats;
+}
+
+std::string ResourceManager::canonical(const std::string &pFileName) {
+  bool absolute = !pFileName.empty() && ('/' == pFileName[0] || '\\' == pFileName[0]);
+  std::vector<std::string> segments;
+  size_t start = 0;
+  while (start <= pFileName.size()) {
+    size_t end = pFileName.find_first_of("/\\", start);
+    if (std::string::npos == end) {
+      end = pFileName.size();
+    }
+    std::string segment = pFileName.substr(start, end - start);
+    if (".." == segment) {
+      // Leading ".." segments of a relative path have nothing to fold into.
+      if (!segments.empty() && ".." != segments.back()) {
+        segments.pop_back();
+      } else if (!absolute) {
+        segments.push_back(segment);
+      }
+    } else if (!segment.empty() && "." != segment) {
+      segments.push_back(segment);
+    }
+    start = end + 1;
+  }
+  std::string result = absolute ? "/" : "";
+  for (size_t i = 0; i < segments.size(); i++) {
+    result += (0 == i ? "" : "/") + segments[i];
+  }
+  return result.empty() && !pFileName.empty() ? "." : result;
+}
@@ -0,0 +1,52 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <SDL2/SDL.h>
+
+typedef std::shared_ptr<SDL_Texture> TextureHandle;
+typedef std::shared_ptr<SDL_Surface> SurfaceHandle;
+
+/*
+ * Interns bitmaps by canonical path, so every request for the same file
+ * shares one decoded surface or uploaded texture.  Handles are reference
+ * counted; the resource is freed as soon as the last one is released, and a
+ * later request loads it again.  The manager itself only keeps weak
+ * references, so it may be destroyed first, but every texture handle must
+ * be released before the renderer is destroyed.
+ */
+class ResourceManager {
+  public:
+    struct Stats {
+      unsigned long hits;
+      unsigned long misses;
+    };
+
+    explicit ResourceManager(SDL_Renderer *pRenderer);
+    ResourceManager(const ResourceManager &) = delete;
+    ResourceManager &operator=(const ResourceManager &) = delete;
+
+    // Returns nullptr and leaves SDL_GetError set if the file fails to load.
+    TextureHandle texture(const std::string &pFileName);
+    SurfaceHandle surface(const std::string &pFileName);
+    // Resources that still have a live handle.
+    int resident(void) const;
+    const Stats &stats(void) const;
+
+    // Folds separators and "." and ".." segments, without touching the file
+    // system, so equivalent spellings of a path share one entry.
+    static std::string canonical(const std::string &pFileName);
+
+  private:
+    SurfaceHandle load(const std::string &pKey);
+    void prune(void);
+
+    SDL_Renderer *mRenderer;
+    std::map<std::string, std::weak_ptr<SDL_Texture> > mTextures;
+    std::map<std::string, std::weak_ptr<SDL_Surface> > mSurfaces;
+    Stats mStats;
+};
+
+#endif // RESOURCE_MANAGER_H
@@ -0,0 +1,73 @@
+#ifndef RETAINED_CANVAS_H
+#define RETAINED_CANVAS_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * Optional retained rendering.  The scene is kept in a persistent target
+ * texture; each frame the caller reports the bounds of every moving object
+ * with track(), and begin() collects the regions that changed since the last
+ * frame.  Overlapping regions are merged, so they never overlap each other,
+ * and the caller redraws each one in turn after clipTo().  end() copies the
+ * backbuffer to the window; it has to copy all of it, because SDL leaves the
+ * window's contents undefined after SDL_RenderPresent.  Without create() (or
+ * if the renderer has no render targets) begin() just clears the window and
+ * the caller redraws everything once, as before.
+ */
+class RetainedCanvas {
+  public:
+    explicit RetainedCanvas(SDL_Renderer *pRenderer);
+    ~RetainedCanvas(void);
+    RetainedCanvas(const RetainedCanvas &) = delete;
+    RetainedCanvas &operator=(const RetainedCanvas &) = delete;
+
+    // Returns false and leaves SDL_GetError set if the backbuffer cannot be
+    // created; the canvas then stays in immediate mode.
+    bool create(int pWidth, int pHeight);
+    bool retained(void) const;
+
+    // Where object pId is drawn this frame.  Objects whose bounds differ
+    // from the previous frame, or that were not tracked again, are dirty.
+    void track(int pId, const SDL_Rect &pBounds);
+    // Marks pArea, or the whole canvas for nullptr, for redrawing.
+    void invalidate(const SDL_Rect *pArea = nullptr);
+
+    // Prepares the frame; false means nothing changed and drawing may be
+    // skipped.  The dirty regions are cleared with the current draw colour.
+    bool begin(void);
+    // The regions to redraw after begin(), and clipping to one of them.  In
+    // immediate mode there is one region, the whole window.
+    int regions(void) const;
+    void clipTo(int pRegion);
+    void end(void);
+
+    // Average fraction of the canvas written per frame: the regions redrawn
+    // plus the copy of the whole backbuffer to the window.
+    double redrawFraction(void) const;
+    void clear(void);
+
+  private:
+    struct Tracked {
+      bool used;
+      SDL_Rect bounds;
+    };
+
+    void addDirty(const SDL_Rect &pArea);
+
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mBackbuffer;
+    int mWidth;
+    int mHeight;
+    bool mFullyDirty;
+    bool mActive;
+    // Regions dirtied for the next frame, and those being redrawn this frame.
+    std::vector<SDL_Rect> mDirty;
+    std::vector<SDL_Rect> mRegions;
+    std::vector<Tracked> mPrevious;
+    std::vector<Tracked> mCurrent;
+    unsigned long mFrames;
+    double mRedrawn;
+};
+
+#endif // RETAINED_CANVAS_H
@@ -0,0 +1,97 @@
+#include "TextureResidency.h"
+
+#include <SDL2/SDL.h>
+
+TextureResidency::TextureResidency(ResourceManager &pResources, size_t pByteBudget) :
+  mResources(pResources),
+  mByteBudget(pByteBudget),
+  mFrame(0),
+  mStats()
+{
+}
+
+TextureResidency::~TextureResidency(void) {
+  clear();
+}
+
+int TextureResidency::add(const std::string &pFileName) {
+  Entry entry = {pFileName, nullptr, 0, 0, false, mRecent.end()};
+  mEntries.push_back(entry);
+  return (int)mEntries.size() - 1;
+}
+
+SDL_Texture *TextureResidency::use(int pId) {
+  Entry &entry = mEntries[pId];
+  if (nullptr != entry.texture) {
+    mRecent.splice(mRecent.begin(), mRecent, entry.position);
+    entry.lastUse = mFrame;
+    return entry.texture.get();
+  }
+  Uint64 start = SDL_GetPerformanceCounter();
+  TextureHandle texture = mResources.texture(entry.fileName);
+  if (nullptr == texture) {
+    return nullptr;
+  }
+  if (entry.loaded) {
+    mStats.reloads++;
+    mStats.reloadMilliseconds += 1000.0 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+  } else {
+    mStats.loads++;
+    entry.loaded = true;
+  }
+  Uint32 format;
+  int width, height;
+  SDL_QueryTexture(texture.get(), &format, nullptr, &width, &height);
+  entry.texture = texture;
+  entry.bytes = (size_t)width * height * SDL_BYTESPERPIXEL(format);
+  entry.lastUse = mFrame;
+  mRecent.push_front(pId);
+  entry.position = mRecent.begin();
+  mStats.bytes += entry.bytes;
+  mStats.resident++;
+  evict();
+  if (mByteBudget < mStats.bytes) {
+    mStats.overBudget++;
+  }
+  return entry.texture.get();
+}
+
+void TextureResidency::beginFrame(void) {
+  mFrame++;
+}
+
+void TextureResidency::setBudget(size_t pByteBudget) {
+  mByteBudget = pByteBudget;
+  evict();
+}
+
+void TextureResidency::evict(void) {
+  while (mByteBudget < mStats.bytes && !mRecent.empty()) {
+    Entry &oldest = mEntries[mRecent.back()];
+    if (mFrame <= oldest.lastUse + 1) {
+      // Everything still resident was used this frame or the last one.
+      break;
+    }
+    // Frees the texture unless another handle still holds it.
+    oldest.texture.reset();
+    oldest.position = mRecent.end();
+    mStats.bytes -= oldest.bytes;
+    mStats.resident--;
+    mStats.evictions++;
+    mRecent.pop_back();
+  }
+}
+
+const TextureResidency::Stats &TextureResidency::stats(void) const {
+  return mStats;
+}
+
+void TextureResidency::clear(void) {
+  for (Entry &entry : mEntries) {
+    entry.texture.reset();
+    entry.position = mRecent.end();
+  }
+  mRecent.clear();
+  mStats.bytes = 0;
+  mStats.resident = 0;
+}
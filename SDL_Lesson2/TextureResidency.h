@@ -0,0 +1,76 @@
+#ifndef TEXTURE_RESIDENCY_H
+#define TEXTURE_RESIDENCY_H
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "ResourceManager.h"
+
+/*
+ * Keeps the textures of registered files within a byte budget.  use()
+ * returns a file's texture, loading it through the ResourceManager if it is
+ * not resident, and marks it used in the current frame.  A load that takes
+ * the total over the budget releases the least recently used textures,
+ * which are reloaded on their next use.  Textures used in the current or
+ * the previous frame are never evicted, since they will most likely be
+ * wanted again at once; when the working set exceeds the budget it is
+ * overrun instead, and counted in Stats::overBudget, rather than evicting
+ * and reloading the same textures every frame.
+ */
+class TextureResidency {
+  public:
+    struct Stats {
+      unsigned long loads;
+      unsigned long reloads;
+      unsigned long evictions;
+      // Loads that left the total over budget, with nothing evictable.
+      unsigned long overBudget;
+      // Time the render thread spent reloading evicted textures.
+      double reloadMilliseconds;
+      size_t bytes;
+      size_t resident;
+    };
+
+    TextureResidency(ResourceManager &pResources, size_t pByteBudget);
+    ~TextureResidency(void);
+    TextureResidency(const TextureResidency &) = delete;
+    TextureResidency &operator=(const TextureResidency &) = delete;
+
+    // Registers pFileName and returns its id; nothing is loaded until use().
+    int add(const std::string &pFileName);
+    // Returns nullptr and leaves SDL_GetError set if the file fails to load.
+    // The texture stays valid until the next frame's use() calls.
+    SDL_Texture *use(int pId);
+    // Starts a frame; textures not used in the frame just finished become
+    // evictable by later loads.
+    void beginFrame(void);
+    void setBudget(size_t pByteBudget);
+    const Stats &stats(void) const;
+    // Releases every texture; do this before destroying the renderer.
+    void clear(void);
+
+  private:
+    struct Entry {
+      std::string fileName;
+      TextureHandle texture;
+      size_t bytes;
+      unsigned long lastUse;
+      bool loaded;
+      std::list<int>::iterator position;
+    };
+
+    void evict(void);
+
+    ResourceManager &mResources;
+    size_t mByteBudget;
+    unsigned long mFrame;
+    Stats mStats;
+    std::vector<Entry> mEntries;
+    // Resident ids, most recently used first.
+    std::list<int> mRecent;
+};
+
+#endif // TEXTURE_RESIDENCY_H
@@ -3,24 +3,25 @@
 #include <iostream>
 #include <SDL2/SDL.h>
 
+#include "Benchmark.h"
 #include "Constants.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "LessonOptions.h"
+#include "Logger.h"
+#include "ResourceManager.h"
+#include "RetainedCanvas.h"
+#include "TextureResidency.h"
 #include "Utility.h"
 
-void logSdlError(std::ostream &pOutputStream, const std::string pMessage) {
-  pOutputStream << pMessage << " Error: " << SDL_GetError() << std::endl;
+void logSdlError(const char *pMessage) {
+  Logger::console().log(LogLevel::Error, "%s Error: %s", pMessage, SDL_GetError());
 }
 
-SDL_Texture *loadTexture(const std::string &pFileName, SDL_Renderer *pRenderer) {
-  SDL_Texture *texture = nullptr;
-  SDL_Surface *loadedImage = SDL_LoadBMP(pFileName.c_str());
-  if (nullptr == loadedImage) {
-    logSdlError(std::cout, "LoadBMP");
-  } else {
-    texture = SDL_CreateTextureFromSurface(pRenderer, loadedImage);
-    SDL_FreeSurface(loadedImage);
-    if (nullptr == texture) {
-      logSdlError(std::cout, "CreateTextureFromSurface");
-    }
+SDL_Texture *loadTexture(int pTexture, TextureResidency &pResidency) {
+  SDL_Texture *texture = pResidency.use(pTexture);
+  if (nullptr == texture) {
+    logSdlError("LoadTexture");
   }
   return texture;
 }
@@ -34,46 +35,70 @@ void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPosition
 }
 
 int main(int argc, char** argv) {
+  Benchmark benchmark;
+  LessonOptions options(LessonOptions::RETAINED);
+  if (!benchmark.parse(argc, argv, options)) {
+    Benchmark::usage(std::cout, Constants::ApplicationName(), options);
+    return EXIT_FAILURE;
+  }
+  Constants::Config config;
+  if (!benchmark.prepare(config)) {
+    logSdlError("Config");
+    return EXIT_FAILURE;
+  }
   if (0 != SDL_Init(SDL_INIT_VIDEO)) {
-    std::cout << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_Init %s", SDL_GetError());
     return EXIT_FAILURE;
   }
   SDL_Window *window = SDL_CreateWindow(
     Constants::WindowTitle(),
     Constants::WindowPositionX(),
     Constants::WindowPositionY(),
-    Constants::WindowWidth(),
-    Constants::WindowHeight(),
-    SDL_WINDOW_SHOWN
+    config.windowWidth,
+    config.windowHeight,
+    benchmark.windowFlags(SDL_WINDOW_SHOWN)
   );
   if (nullptr == window) {
-    logSdlError(std::cout, "SDL_CreateWindow");
+    logSdlError("SDL_CreateWindow");
     SDL_Quit();
     return EXIT_FAILURE;
   }
   SDL_Renderer *renderer = SDL_CreateRenderer(
     window,
     Constants::DefaultRendererWindow(),
-    SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+    benchmark.rendererFlags(SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
   );
   if (nullptr == renderer) {
-    logSdlError(std::cout, "SDL_CreateRenderer");
+    logSdlError("SDL_CreateRenderer");
     Utility::cleanup(window);
     SDL_Quit();
     return EXIT_FAILURE;
   }
   const std::string resourcePath = Constants::ResourcePath(Constants::ApplicationName());
-  SDL_Texture *background = loadTexture(resourcePath + "background.bmp", renderer);
-  SDL_Texture *image = loadTexture(resourcePath + "image.bmp", renderer);
-  if (nullptr == background || nullptr == image) {
-    Utility::cleanup(background, image, renderer, window);
+  ResourceManager resources(renderer);
+  TextureResidency residency(resources, config.textureBudget);
+  int background = residency.add(resourcePath + "background.bmp");
+  int image = residency.add(resourcePath + "image.bmp");
+  if (nullptr == loadTexture(background, residency) || nullptr == loadTexture(image, residency)) {
+    residency.clear();
+    Utility::cleanup(renderer, window);
     SDL_Quit();
     return EXIT_FAILURE;
   }
 
   bool done = false;
   int frame = 0;
+  FrameScheduler scheduler(config.framesPerSecond, benchmark.enabled() ? FrameMode::Uncapped : FrameMode::Paced);
+  FrameProfiler profiler;
+  RetainedCanvas canvas(renderer);
+  if (options.retained() && !canvas.create(config.windowWidth, config.windowHeight)) {
+    logSdlError("RetainedCanvas");
+  }
+  benchmark.start();
   do {
+    scheduler.beginFrame();
+    profiler.beginFrame();
+    double seconds = scheduler.time();
     SDL_Event event;
     SDL_PollEvent(&event);
     switch (event.type) {
@@ -83,29 +108,72 @@ int main(int argc, char** argv) {
         done = true;
         break;
     }
-    SDL_RenderClear(renderer);
-    int backgroundWidth, backgroundHeight;
-    SDL_QueryTexture(background, nullptr, nullptr, &backgroundWidth, &backgroundHeight);
-    for (int y = 0; y < Constants::WindowHeight(); y += backgroundHeight) {
-      for (int x = 0; x < Constants::WindowWidth(); x += backgroundWidth) {
-        renderTexture(background, renderer, x, y);
+    profiler.mark(FramePhase::Events);
+    residency.beginFrame();
+    // A texture that fails to reload is skipped, with its size left at zero.
+    SDL_Texture *imageTexture = loadTexture(image, residency);
+    int imageWidth = 0;
+    int imageHeight = 0;
+    SDL_QueryTexture(imageTexture, nullptr, nullptr, &imageWidth, &imageHeight);
+    int centerX = (config.windowWidth - imageWidth) / 2;
+    int centerY = (config.windowHeight - imageHeight) / 2;
+    int x = centerX * (1.0 + 0.5 * cos(seconds / 2));
+    int y = centerY * (1.0 + 0.5 * sin(seconds));
+    SDL_Rect imageBounds = {x, y, imageWidth, imageHeight};
+    canvas.track(0, imageBounds);
+    if (canvas.begin()) {
+      profiler.mark(FramePhase::Clear);
+      SDL_Texture *backgroundTexture = loadTexture(background, residency);
+      int backgroundWidth, backgroundHeight;
+      if (0 == SDL_QueryTexture(backgroundTexture, nullptr, nullptr, &backgroundWidth, &backgroundHeight)) {
+        for (int region = 0; region < canvas.regions(); region++) {
+          canvas.clipTo(region);
+          for (int tileY = 0; tileY < config.windowHeight; tileY += backgroundHeight) {
+            for (int tileX = 0; tileX < config.windowWidth; tileX += backgroundWidth) {
+              renderTexture(backgroundTexture, renderer, tileX, tileY);
+            }
+          }
+        }
+      }
+      profiler.mark(FramePhase::Background);
+      // The regions never overlap, so no pixel is drawn twice.
+      for (int region = 0; region < canvas.regions(); region++) {
+        canvas.clipTo(region);
+        renderTexture(imageTexture, renderer, x, y);
       }
+      profiler.mark(FramePhase::Sprites);
     }
-    int imageWidth, imageHeight;
-    SDL_QueryTexture(image, nullptr, nullptr, &imageWidth, &imageHeight);
-    int centerX = (Constants::WindowWidth() - imageWidth) / 2;
-    int centerY = (Constants::WindowHeight() - imageHeight) / 2;
-    int x = centerX * (1.0 + 0.5 * cos((float)frame / (2 * Constants::FramesPerSecond())));
-    int y = centerY * (1.0 + 0.5 * sin((float)frame / Constants::FramesPerSecond()));
-    renderTexture(image, renderer, x, y);
+    canvas.end();
     SDL_RenderPresent(renderer);
-    if (0 == frame % Constants::FramesPerSecond()) {
-      std::cout << "Frame: " << frame << std::endl;
+    profiler.mark(FramePhase::Present);
+    if (!benchmark.enabled() && 0 == frame % config.framesPerSecond) {
+      Logger::console().log(LogLevel::Info, "Frame: %d", frame);
     }
     frame++;
-    SDL_Delay(Constants::FrameWait());
+    done = benchmark.frameDone() || done;
+    scheduler.endFrame();
   } while (!done);
-  Utility::cleanup(background, image, renderer, window);
+  Logger::console().flush();
+  if (canvas.retained() && !benchmark.enabled()) {
+    std::cout << "RetainedCanvas redrew " << 100.0 * canvas.redrawFraction() << "% of the window per frame, including the copy to the window" << std::endl;
+  }
+  canvas.clear();
+  if (benchmark.enabled()) {
+    benchmark.report(std::cout, Constants::ApplicationName(), options, profiler);
+  } else {
+    profiler.report(std::cout);
+  }
+  if (!benchmark.enabled()) {
+    const TextureResidency::Stats &textureStats = residency.stats();
+    std::cout << "TextureResidency loads: " << textureStats.loads
+      << " reloads: " << textureStats.reloads
+      << " (" << textureStats.reloadMilliseconds << " ms)"
+      << " evictions: " << textureStats.evictions
+      << " over budget: " << textureStats.overBudget
+      << " bytes: " << textureStats.bytes << std::endl;
+  }
+  residency.clear();
+  Utility::cleanup(renderer, window);
   SDL_Quit();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,190 @@
+#include "AsyncTextureLoader.h"
+
+#include <algorithm>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "Utility.h"
+
+AsyncTextureLoader::AsyncTextureLoader(
+  SDL_Renderer *pRenderer,
+  int pThreads,
+  const ResourcePack *pPack,
+  ImageCache *pCache
+) :
+  mRenderer(pRenderer),
+  mPack(pPack),
+  mCache(pCache),
+  mPlaceholder(nullptr),
+  mStopping(false),
+  mCompleted(nullptr),
+  mPending(0)
+{
+  SDL_Surface *blank = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_ARGB8888);
+  if (nullptr != blank) {
+    SDL_FillRect(blank, nullptr, 0);
+    mPlaceholder = SDL_CreateTextureFromSurface(mRenderer, blank);
+    Utility::cleanup(blank);
+    SDL_SetTextureBlendMode(mPlaceholder, SDL_BLENDMODE_BLEND);
+  }
+  int threads = 0 < pThreads ? pThreads : std::max(1, SDL_GetCPUCount() - 1);
+  for (int i = 0; i < threads; i++) {
+    mThreads.push_back(std::thread(&AsyncTextureLoader::work, this));
+  }
+}
+
+AsyncTextureLoader::~AsyncTextureLoader(void) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWake.notify_all();
+  for (std::thread &thread : mThreads) {
+    thread.join();
+  }
+  collect();
+  // Loads that never reached update() fail, so handles still held elsewhere
+  // do not wait on them forever.
+  for (Completion *completion : mReady) {
+    Utility::cleanup(completion->surface);
+    completion->handle->failed = true;
+    mPending--;
+    delete completion;
+  }
+  mReady.clear();
+  clear();
+}
+
+SDL_Surface *AsyncTextureLoader::decodeSurface(const std::string &pFileName) const {
+  if (nullptr != mCache) {
+    return mCache->decode(pFileName, mPack);
+  }
+  SDL_RWops *packed = nullptr == mPack ? nullptr : mPack->openRW(pFileName);
+  SDL_Surface *loaded = nullptr == packed ? IMG_Load(pFileName.c_str()) : IMG_Load_RW(packed, 1);
+  if (nullptr == loaded) {
+    return nullptr;
+  }
+  // Convert here so the render thread only has to copy pixels.
+  SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+  Utility::cleanup(loaded);
+  return converted;
+}
+
+void AsyncTextureLoader::work(void) {
+  for (;;) {
+    Job job;
+    bool abandoned;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWake.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+      if (mJobs.empty()) {
+        return;
+      }
+      job = mJobs.front();
+      mJobs.pop_front();
+      abandoned = mStopping;
+    }
+    // Jobs still queued at shutdown are answered with nullptr rather than
+    // decoded, so every future gets a value and every load completes.
+    SDL_Surface *surface = abandoned ? nullptr : decodeSurface(job.fileName);
+    if (job.promise) {
+      job.promise->set_value(surface);
+    } else {
+      complete(new Completion{job.handle, surface, nullptr});
+    }
+  }
+}
+
+void AsyncTextureLoader::enqueue(const Job &pJob) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mJobs.push_back(pJob);
+  }
+  mWake.notify_one();
+}
+
+void AsyncTextureLoader::complete(Completion *pCompletion) {
+  // Multi-producer push onto an intrusive stack; the render thread takes
+  // the whole stack at once in collect().
+  Completion *head = mCompleted.load(std::memory_order_relaxed);
+  do {
+    pCompletion->next = head;
+  } while (!mCompleted.compare_exchange_weak(head, pCompletion, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void AsyncTextureLoader::collect(void) {
+  Completion *stack = mCompleted.exchange(nullptr, std::memory_order_acquire);
+  std::deque<Completion *> batch;
+  for (; nullptr != stack; stack = stack->next) {
+    batch.push_front(stack);
+  }
+  mReady.insert(mReady.end(), batch.begin(), batch.end());
+}
+
+AsyncTextureHandle AsyncTextureLoader::load(const std::string &pFileName) {
+  AsyncTextureHandle handle = std::make_shared<AsyncTexture>();
+  handle->texture = nullptr;
+  handle->failed = false;
+  handle->width = 0;
+  handle->height = 0;
+  mPending++;
+  enqueue(Job{pFileName, handle, nullptr});
+  return handle;
+}
+
+std::future<SDL_Surface *> AsyncTextureLoader::decode(const std::string &pFileName) {
+  std::shared_ptr<std::promise<SDL_Surface *> > promise = std::make_shared<std::promise<SDL_Surface *> >();
+  std::future<SDL_Surface *> result = promise->get_future();
+  enqueue(Job{pFileName, nullptr, promise});
+  return result;
+}
+
+void AsyncTextureLoader::upload(Completion *pCompletion) {
+  AsyncTexture &texture = *pCompletion->handle;
+  if (nullptr == pCompletion->surface) {
+    texture.failed = true;
+  } else {
+    texture.texture = SDL_CreateTextureFromSurface(mRenderer, pCompletion->surface);
+    texture.failed = nullptr == texture.texture;
+    texture.width = pCompletion->surface->w;
+    texture.height = pCompletion->surface->h;
+    Utility::cleanup(pCompletion->surface);
+    if (!texture.failed) {
+      mLoaded.push_back(pCompletion->handle);
+    }
+  }
+  mPending--;
+  delete pCompletion;
+}
+
+int AsyncTextureLoader::update(double pBudgetMilliseconds) {
+  collect();
+  Uint64 start = SDL_GetPerformanceCounter();
+  Uint64 budget = pBudgetMilliseconds * SDL_GetPerformanceFrequency() / 1000.0;
+  int uploads = 0;
+  // Always make progress, even when the budget is smaller than one upload.
+  while (!mReady.empty() && (0 == uploads || SDL_GetPerformanceCounter() - start < budget)) {
+    upload(mReady.front());
+    mReady.pop_front();
+    uploads++;
+  }
+  return uploads;
+}
+
+SDL_Texture *AsyncTextureLoader::texture(const AsyncTextureHandle &pHandle) const {
+  return nullptr != pHandle && nullptr != pHandle->texture ? pHandle->texture : mPlaceholder;
+}
+
+int AsyncTextureLoader::pending(void) const {
+  return mPending;
+}
+
+void AsyncTextureLoader::clear(void) {
+  for (AsyncTextureHandle &handle : mLoaded) {
+    Utility::cleanup(handle->texture);
+    handle->texture = nullptr;
+  }
+  mLoaded.clear();
+  Utility::cleanup(mPlaceholder);
+  mPlaceholder = nullptr;
+}
@@ -0,0 +1,95 @@
+#ifndef ASYNC_TEXTURE_LOADER_H
+#define ASYNC_TEXTURE_LOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "ImageCache.h"
+#include "ResourcePack.h"
+
+/*
+ * State of one asynchronous load.  texture stays nullptr until the surface
+ * has been uploaded by AsyncTextureLoader::update().
+ */
+struct AsyncTexture {
+  SDL_Texture *texture;
+  bool failed;
+  int width;
+  int height;
+};
+typedef std::shared_ptr<AsyncTexture> AsyncTextureHandle;
+
+/*
+ * Decodes images to surfaces on a pool of worker threads.  Finished
+ * surfaces come back through a lock-free queue and are uploaded on the
+ * render thread by update(), within a per-frame time budget.  The loader
+ * owns every texture it uploads; clear() it before destroying the renderer.
+ */
+class AsyncTextureLoader {
+  public:
+    // pThreads <= 0 uses one worker per CPU, less one for the render thread.
+    // Files found in pPack are decoded from its mapping instead of disk, and
+    // with pCache decoded pixels are reused across runs.
+    explicit AsyncTextureLoader(
+      SDL_Renderer *pRenderer,
+      int pThreads = 0,
+      const ResourcePack *pPack = nullptr,
+      ImageCache *pCache = nullptr
+    );
+    ~AsyncTextureLoader(void);
+    AsyncTextureLoader(const AsyncTextureLoader &) = delete;
+    AsyncTextureLoader &operator=(const AsyncTextureLoader &) = delete;
+
+    AsyncTextureHandle load(const std::string &pFileName);
+    // Decodes to an ARGB8888 surface owned by the caller, or nullptr.
+    std::future<SDL_Surface *> decode(const std::string &pFileName);
+    // Uploads finished loads until pBudgetMilliseconds is spent.
+    int update(double pBudgetMilliseconds);
+    // The loaded texture, or a transparent placeholder until it is ready.
+    SDL_Texture *texture(const AsyncTextureHandle &pHandle) const;
+    int pending(void) const;
+    void clear(void);
+
+  private:
+    struct Job {
+      std::string fileName;
+      AsyncTextureHandle handle;
+      std::shared_ptr<std::promise<SDL_Surface *> > promise;
+    };
+    struct Completion {
+      AsyncTextureHandle handle;
+      SDL_Surface *surface;
+      Completion *next;
+    };
+
+    SDL_Surface *decodeSurface(const std::string &pFileName) const;
+    void work(void);
+    void enqueue(const Job &pJob);
+    void complete(Completion *pCompletion);
+    void collect(void);
+    void upload(Completion *pCompletion);
+
+    SDL_Renderer *mRenderer;
+    const ResourcePack *mPack;
+    ImageCache *mCache;
+    SDL_Texture *mPlaceholder;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::deque<Job> mJobs;
+    bool mStopping;
+    std::atomic<Completion *> mCompleted;
+    std::deque<Completion *> mReady;
+    std::atomic<int> mPending;
+    std::vector<AsyncTextureHandle> mLoaded;
+};
+
+#endif // ASYNC_TEXTURE_LOADER_H
@@ -0,0 +1,52 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <atomic>
+#include <string>
+#include <SDL2/SDL.h>
+
+#include "ResourcePack.h"
+
+/*
+ * On-disk cache of decoded images.  Each entry is a raw pixel blob in the
+ * upload format behind a small header recording its dimensions, format and
+ * a stamp of the source (modification time and size for loose files, a
+ * content hash for packed ones).  A stale or missing entry is rebuilt from
+ * the source on the next decode().  Safe to call from several threads as
+ * long as they decode different files.
+ */
+class ImageCache {
+  public:
+    // An empty pDirectory disables the cache; decode() then always decodes.
+    explicit ImageCache(const std::string &pDirectory, Uint32 pFormat = SDL_PIXELFORMAT_ARGB8888);
+    ImageCache(const ImageCache &) = delete;
+    ImageCache &operator=(const ImageCache &) = delete;
+
+    // Returns a surface owned by the caller, or nullptr if pFileName cannot
+    // be decoded.  Files found in pPack are read from its mapping.
+    SDL_Surface *decode(const std::string &pFileName, const ResourcePack *pPack = nullptr);
+    unsigned long hits(void) const;
+    unsigned long misses(void) const;
+
+  private:
+    struct Header {
+      char magic[8];
+      Uint32 format;
+      Sint32 width;
+      Sint32 height;
+      Sint32 pitch;
+      Uint64 sourceStamp;
+      Uint64 sourceSize;
+    };
+
+    std::string entryPath(const std::string &pFileName) const;
+    SDL_Surface *read(const std::string &pPath, Uint64 pStamp, Uint64 pSize) const;
+    void write(const std::string &pPath, const SDL_Surface *pSurface, Uint64 pStamp, Uint64 pSize) const;
+
+    std::string mDirectory;
+    Uint32 mFormat;
+    std::atomic<unsigned long> mHits;
+    std::atomic<unsigned long> mMisses;
+};
+
+#endif // IMAGE_CACHE_H
@@ -0,0 +1,190 @@
+#include "ResourcePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <SDL2/SDL.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+ResourcePack::ResourcePack(void) :
+  mData(nullptr),
+  mSize(0),
+  mEntries(nullptr),
+  mEntryCount(0),
+  mNames(nullptr)
+  #ifdef _WIN32
+    , mFile(nullptr)
+    , mMapping(nullptr)
+  #endif
+{
+}
+
+ResourcePack::~ResourcePack(void) {
+  close();
+}
+
+bool ResourcePack::isOpen(void) const {
+  return nullptr != mData;
+}
+
+void ResourcePack::close(void) {
+  if (nullptr != mData) {
+    #ifdef _WIN32
+      UnmapViewOfFile(mData);
+      CloseHandle(mMapping);
+      CloseHandle(mFile);
+      mMapping = nullptr;
+      mFile = nullptr;
+    #else
+      munmap(const_cast<unsigned char *>(mData), mSize);
+    #endif
+  }
+  mData = nullptr;
+  mSize = 0;
+  mEntries = nullptr;
+  mEntryCount = 0;
+  mNames = nullptr;
+}
+
+bool ResourcePack::open(const std::string &pPackPath, const std::string &pRoot) {
+  close();
+  #ifdef _WIN32
+    HANDLE file = CreateFileA(pPackPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+      SDL_SetError("Could not open %s", pPackPath.c_str());
+      return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && 0 < size.QuadPart) {
+      mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (nullptr == mapping) {
+      CloseHandle(file);
+      SDL_SetError("Could not map %s", pPackPath.c_str());
+      return false;
+    }
+    mFile = file;
+    mMapping = mapping;
+    mSize = size.QuadPart;
+    mData = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  #else
+    int file = ::open(pPackPath.c_str(), O_RDONLY);
+    if (file < 0) {
+      SDL_SetError("Could not open %s", pPackPath.c_str());
+      return false;
+    }
+    struct stat status;
+    void *mapping = MAP_FAILED;
+    if (0 == fstat(file, &status) && 0 < status.st_size) {
+      mSize = status.st_size;
+      mapping = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    // The mapping keeps the file referenced.
+    ::close(file);
+    mData = MAP_FAILED == mapping ? nullptr : static_cast<const unsigned char *>(mapping);
+  #endif
+  if (nullptr == mData) {
+    close();
+    SDL_SetError("Could not map %s", pPackPath.c_str());
+    return false;
+  }
+
+  PackHeader header;
+  bool valid = sizeof(header) <= mSize;
+  if (valid) {
+    memcpy(&header, mData, sizeof(header));
+    valid = 0 == memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC))
+      && PACK_VERSION == header.version
+      && header.indexOffset % alignof(PackEntry) == 0
+      && header.indexOffset <= header.namesOffset
+      && (Uint64)header.entryCount * sizeof(PackEntry) <= header.namesOffset - header.indexOffset
+      && header.namesOffset <= mSize;
+  }
+  if (!valid) {
+    close();
+    SDL_SetError("%s is not a version %u resource pack", pPackPath.c_str(), PACK_VERSION);
+    return false;
+  }
+  // Check every entry once here, so lookups can trust the index.  Each
+  // comparison is arranged so it cannot wrap.
+  const PackEntry *entries = reinterpret_cast<const PackEntry *>(mData + header.indexOffset);
+  Uint64 namesSize = mSize - header.namesOffset;
+  for (Uint32 i = 0; i < header.entryCount && valid; i++) {
+    const PackEntry &entry = entries[i];
+    valid = entry.nameOffset <= namesSize
+      && entry.nameLength <= namesSize - entry.nameOffset
+      && entry.offset <= mSize
+      && entry.size <= mSize - entry.offset
+      && (0 == i || entries[i - 1].hash <= entry.hash);
+  }
+  if (!valid) {
+    close();
+    SDL_SetError("%s has a corrupt index", pPackPath.c_str());
+    return false;
+  }
+  mEntries = entries;
+  mEntryCount = header.entryCount;
+  mNames = reinterpret_cast<const char *>(mData + header.namesOffset);
+  mRoot = pRoot;
+  return true;
+}
+
+std::string ResourcePack::relative(const std::string &pPath) const {
+  std::string result = pPath;
+  if (!mRoot.empty() && 0 == result.compare(0, mRoot.size(), mRoot)) {
+    result.erase(0, mRoot.size());
+  }
+  std::replace(result.begin(), result.end(), '\\', '/');
+  return result;
+}
+
+const void *ResourcePack::find(const std::string &pPath, size_t *pSize) const {
+  if (nullptr == mData) {
+    return nullptr;
+  }
+  const std::string name = relative(pPath);
+  const Uint64 hash = packHash(name);
+  const PackEntry *end = mEntries + mEntryCount;
+  const PackEntry *entry = std::lower_bound(mEntries, end, hash, [](const PackEntry &pEntry, Uint64 pHash) {
+    return pEntry.hash < pHash;
+  });
+  for (; end != entry && hash == entry->hash; entry++) {
+    if (name.size() == entry->nameLength && 0 == memcmp(name.data(), mNames + entry->nameOffset, name.size())) {
+      if (nullptr != pSize) {
+        *pSize = entry->size;
+      }
+      return mData + entry->offset;
+    }
+  }
+  return nullptr;
+}
+
+SDL_RWops *ResourcePack::openRW(const std::string &pPath) const {
+  size_t size = 0;
+  const void *data = find(pPath, &size);
+  return nullptr == data ? nullptr : SDL_RWFromConstMem(data, size);
+}
+
+std::vector<std::string> ResourcePack::list(const std::string &pDirectory) const {
+  std::vector<std::string> result;
+  std::string prefix = relative(pDirectory);
+  if (!prefix.empty() && '/' != prefix[prefix.size() - 1]) {
+    prefix += '/';
+  }
+  for (Uint32 i = 0; i < mEntryCount; i++) {
+    std::string name(mNames + mEntries[i].nameOffset, mEntries[i].nameLength);
+    if (0 == name.compare(0, prefix.size(), prefix) && std::string::npos == name.find('/', prefix.size())) {
+      result.push_back(name.substr(prefix.size()));
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
@@ -1,46 +1,82 @@
 #include <cstdlib>
-#include <cmath>
 #include <iostream>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 
+#include "Animator.h"
+#include "AsyncTextureLoader.h"
+#include "Benchmark.h"
 #include "Constants.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "ImageCache.h"
+#include "LessonOptions.h"
+#include "Logger.h"
+#include "ResourcePack.h"
+#include "SpriteBatch.h"
 #include "Utility.h"
 
-void logSdlError(std::ostream &pOutputStream, const std::string pMessage) {
-  pOutputStream << pMessage << " Error: " << SDL_GetError() << std::endl;
+void logSdlError(const char *pMessage) {
+  Logger::console().log(LogLevel::Error, "%s Error: %s", pMessage, SDL_GetError());
 }
 
-SDL_Texture *loadTexture(const std::string &pFileName, SDL_Renderer *pRenderer) {
-  SDL_Texture *texture = IMG_LoadTexture(pRenderer, pFileName.c_str());
-  if (nullptr == texture) {
-    logSdlError(std::cout, "LoadTexture");
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, SDL_Rect pDestination, SDL_Rect *pClip = nullptr) {
+  SpriteBatch *batch = SpriteBatch::current(pRenderer);
+  if (nullptr == batch) {
+    SDL_RenderCopy(pRenderer, pTexture, pClip, &pDestination);
+  } else {
+    batch->draw(pTexture, pDestination, pClip);
   }
-  return texture;
 }
 
-void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPositionX, int pPositionY, int pWidth, int pHeight) {
+void renderTexture(
+  SDL_Texture *pTexture,
+  SDL_Renderer *pRenderer,
+  int pPositionX,
+  int pPositionY,
+  int pWidth,
+  int pHeight,
+  SDL_Rect *pClip = nullptr
+) {
   SDL_Rect destination;
   destination.x = pPositionX;
   destination.y = pPositionY;
   destination.w = pWidth;
   destination.h = pHeight;
-  SDL_RenderCopy(pRenderer, pTexture, nullptr, &destination);
+  renderTexture(pTexture, pRenderer, destination, pClip);
 }
 
-void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPositionX, int pPositionY) {
-  int width, height;
-  SDL_QueryTexture(pTexture, nullptr, nullptr, &width, &height);
-  renderTexture(pTexture, pRenderer, pPositionX, pPositionY, width, height);
+void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPositionX, int pPositionY, SDL_Rect *pClip = nullptr) {
+  SDL_Rect destination;
+  destination.x = pPositionX;
+  destination.y = pPositionY;
+  if (nullptr == pClip) {
+    SDL_QueryTexture(pTexture, nullptr, nullptr, &destination.w, &destination.h);
+  } else {
+    destination.w = pClip->w;
+    destination.h = pClip->h;
+  }
+  renderTexture(pTexture, pRenderer, destination, pClip);
 }
 
 int main(int argc, char** argv) {
+  Benchmark benchmark;
+  LessonOptions options(0);
+  if (!benchmark.parse(argc, argv, options)) {
+    Benchmark::usage(std::cout, Constants::ApplicationName(), options);
+    return EXIT_FAILURE;
+  }
+  Constants::Config config;
+  if (!benchmark.prepare(config)) {
+    logSdlError("Config");
+    return EXIT_FAILURE;
+  }
   if (0 != SDL_Init(SDL_INIT_VIDEO)) {
-    std::cout << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_Init %s", SDL_GetError());
     return EXIT_FAILURE;
   }
   if (IMG_INIT_PNG != (IMG_INIT_PNG & IMG_Init(IMG_INIT_PNG))) {
-    logSdlError(std::cout, "IMG_Init");
+    logSdlError("IMG_Init");
     SDL_Quit();
     return EXIT_FAILURE;
   }
@@ -48,40 +84,64 @@ int main(int argc, char** argv) {
     Constants::WindowTitle(),
     Constants::WindowPositionX(),
     Constants::WindowPositionY(),
-    Constants::WindowWidth(),
-    Constants::WindowHeight(),
-    SDL_WINDOW_SHOWN
+    config.windowWidth,
+    config.windowHeight,
+    benchmark.windowFlags(SDL_WINDOW_SHOWN)
   );
   if (nullptr == window) {
-    logSdlError(std::cout, "SDL_CreateWindow");
+    logSdlError("SDL_CreateWindow");
     SDL_Quit();
     return EXIT_FAILURE;
   }
   SDL_Renderer *renderer = SDL_CreateRenderer(
     window,
     Constants::DefaultRendererWindow(),
-    SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+    benchmark.rendererFlags(SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
   );
   if (nullptr == renderer) {
-    logSdlError(std::cout, "SDL_CreateRenderer");
+    logSdlError("SDL_CreateRenderer");
     Utility::cleanup(window);
     IMG_Quit();
     SDL_Quit();
     return EXIT_FAILURE;
   }
+  SpriteBatch batch(renderer);
   const std::string resourcePath = Constants::ResourcePath(Constants::ApplicationName());
-  SDL_Texture *background = loadTexture(resourcePath + "background.png", renderer);
-  SDL_Texture *image = loadTexture(resourcePath + "image.png", renderer);
-  if (nullptr == background || nullptr == image) {
-    Utility::cleanup(background, image, renderer, window);
-    IMG_Quit();
-    SDL_Quit();
-    return EXIT_FAILURE;
-  }
+  // The pack is optional; without one, assets are read from res/.
+  ResourcePack pack;
+  pack.open(Constants::ResourcePackPath(), Constants::ResourcePath(""));
+  ImageCache imageCache(Constants::ImageCachePath());
+  // The loop starts at once, drawing placeholders until each image has
+  // decoded on a worker and been uploaded by loader.update().
+  AsyncTextureLoader loader(renderer, 0, &pack, &imageCache);
+  AsyncTextureHandle background = loader.load(resourcePath + "background.png");
+  AsyncTextureHandle image = loader.load(resourcePath + "image.png");
 
   bool done = false;
   int frame = 0;
+  FrameScheduler scheduler(config.framesPerSecond, benchmark.enabled() ? FrameMode::Uncapped : FrameMode::Paced);
+  FrameProfiler profiler;
+  Animator animator;
+  float pulseX, pulseY, orbitX, orbitY;
+  animator.cosine(&pulseX, 1.0f, 0.5f, 2.0f);
+  animator.sine(&pulseY, 1.0f, 0.5f, 2.0f);
+  animator.cosine(&orbitX, 1.0f, 0.5f, 0.5f);
+  animator.sine(&orbitY, 1.0f, 0.5f, 1.0f);
+  bool failed = false;
+  benchmark.start();
   do {
+    scheduler.beginFrame();
+    profiler.beginFrame();
+    double seconds = scheduler.time();
+    animator.update(seconds);
+    if (0 < loader.pending()) {
+      loader.update(config.uploadMilliseconds);
+      if (background->failed || image->failed) {
+        Logger::console().log(LogLevel::Error, "LoadTexture Error: could not load %s", background->failed ? "background.png" : "image.png");
+        failed = true;
+        done = true;
+      }
+    }
     SDL_Event event;
     SDL_PollEvent(&event);
     switch (event.type) {
@@ -91,35 +151,50 @@ int main(int argc, char** argv) {
         done = true;
         break;
     }
+    profiler.mark(FramePhase::Events);
     SDL_RenderClear(renderer);
-    int tileWidth = Constants::TileSize();
-    int tileHeight = Constants::TileSize();
-    int offsetX = (frame / 2) % tileWidth - tileWidth;
-    int offsetY = (-frame / 3) % tileHeight - tileHeight;
-    for (int y = offsetY; y < Constants::WindowHeight(); y += tileHeight) {
-      for (int x = offsetX; x < Constants::WindowWidth(); x += tileWidth) {
-        renderTexture(background, renderer, x, y, tileWidth, tileHeight);
+    profiler.mark(FramePhase::Clear);
+    batch.begin();
+    int tileWidth = config.tileSize;
+    int tileHeight = config.tileSize;
+    int offsetX = (int)(seconds * 30) % tileWidth - tileWidth;
+    int offsetY = (int)(seconds * -20) % tileHeight - tileHeight;
+    for (int y = offsetY; y < config.windowHeight; y += tileHeight) {
+      for (int x = offsetX; x < config.windowWidth; x += tileWidth) {
+        renderTexture(loader.texture(background), renderer, x, y, tileWidth, tileHeight);
       }
     }
-    int imageWidth, imageHeight;
-    SDL_QueryTexture(image, nullptr, nullptr, &imageWidth, &imageHeight);
-    imageWidth *= 1.0 + 0.5 * cos((float)frame / (Constants::FramesPerSecond() / 2));
-    imageHeight *= 1.0 + 0.5 * sin((float)frame / (Constants::FramesPerSecond() / 2));
-    int centerX = (Constants::WindowWidth() - imageWidth) / 2;
-    int centerY = (Constants::WindowHeight() - imageHeight) / 2;
-    int x = centerX * (1.0 + 0.5 * cos((float)frame / (2 * Constants::FramesPerSecond())));
-    int y = centerY * (1.0 + 0.5 * sin((float)frame / Constants::FramesPerSecond()));
-    renderTexture(image, renderer, x, y, imageWidth, imageHeight);
+    profiler.mark(FramePhase::Background);
+    int imageWidth = image->width;
+    int imageHeight = image->height;
+    imageWidth *= pulseX;
+    imageHeight *= pulseY;
+    int centerX = (config.windowWidth - imageWidth) / 2;
+    int centerY = (config.windowHeight - imageHeight) / 2;
+    int x = centerX * orbitX;
+    int y = centerY * orbitY;
+    renderTexture(loader.texture(image), renderer, x, y, imageWidth, imageHeight);
+    batch.end();
+    profiler.mark(FramePhase::Sprites);
     SDL_RenderPresent(renderer);
-    if (0 == frame % Constants::FramesPerSecond()) {
-      std::cout << "Frame: " << frame << std::endl;
+    profiler.mark(FramePhase::Present);
+    if (!benchmark.enabled() && 0 == frame % config.framesPerSecond) {
+      Logger::console().log(LogLevel::Info, "Frame: %d", frame);
     }
     frame++;
-    SDL_Delay(Constants::FrameWait());
+    done = benchmark.frameDone() || done;
+    scheduler.endFrame();
   } while (!done);
-  Utility::cleanup(background, image, renderer, window);
+  Logger::console().flush();
+  if (benchmark.enabled()) {
+    benchmark.report(std::cout, Constants::ApplicationName(), options, profiler);
+  } else {
+    profiler.report(std::cout);
+  }
+  loader.clear();
+  Utility::cleanup(renderer, window);
   IMG_Quit();
   SDL_Quit();
-  return EXIT_SUCCESS;
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
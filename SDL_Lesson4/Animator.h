@@ -0,0 +1,109 @@
+#ifndef ANIMATOR_H
+#define ANIMATOR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <SDL2/SDL.h>
+
+enum class Easing {
+  Linear,
+  InQuad,
+  OutQuad,
+  InOutQuad,
+  InOutCubic
+};
+
+/*
+ * Evaluates declarative animation tracks and writes each result to the
+ * float it is bound to.  Tracks of each kind are stored as parallel arrays
+ * and evaluated in straight loops over them; sinusoids use a polynomial
+ * approximation instead of libm so the loops vectorise.  Bound floats must
+ * outlive their tracks.
+ */
+class Animator {
+  public:
+    typedef Uint32 Track;
+
+    Animator(void);
+    Animator(const Animator &) = delete;
+    Animator &operator=(const Animator &) = delete;
+
+    // pOffset + pAmplitude * sin(pRadiansPerSecond * t + pPhase)
+    Track sine(float *pTarget, float pOffset, float pAmplitude, float pRadiansPerSecond, float pPhase = 0.0f);
+    // pOffset + pAmplitude * cos(pRadiansPerSecond * t + pPhase)
+    Track cosine(float *pTarget, float pOffset, float pAmplitude, float pRadiansPerSecond, float pPhase = 0.0f);
+    // Eases from pFrom to pTo over [pStart, pStart + pDuration), then holds
+    // or, with pLoop, restarts.
+    Track tween(
+      float *pTarget,
+      float pFrom,
+      float pTo,
+      float pStart,
+      float pDuration,
+      Easing pEasing = Easing::Linear,
+      bool pLoop = false
+    );
+    Track linear(float *pTarget, float pFrom, float pTo, float pStart, float pDuration, bool pLoop = false);
+    // Piecewise linear through (time, value) keys sorted by time.
+    Track keyframes(float *pTarget, const std::vector<std::pair<float, float> > &pKeys, bool pLoop = false);
+    // Stops a track; its bound float keeps the last value written.
+    void remove(Track pTrack);
+    void clear(void);
+
+    // Evaluates every track at pSeconds and stores the results.
+    void update(double pSeconds);
+    size_t size(void) const;
+
+  private:
+    enum Kind {
+      SINE,
+      TWEEN,
+      KEYFRAMES
+    };
+    struct Location {
+      Kind kind;
+      size_t index;
+      bool live;
+    };
+    struct SineTracks {
+      std::vector<float *> targets;
+      std::vector<float> offsets;
+      std::vector<float> amplitudes;
+      std::vector<float> frequencies;
+      std::vector<float> phases;
+      std::vector<float> values;
+      std::vector<Track> handles;
+    };
+    struct TweenTracks {
+      std::vector<float *> targets;
+      std::vector<float> from;
+      std::vector<float> to;
+      std::vector<float> starts;
+      std::vector<float> durations;
+      std::vector<Easing> easings;
+      std::vector<Uint8> loops;
+      std::vector<float> values;
+      std::vector<Track> handles;
+    };
+    struct KeyframeTracks {
+      std::vector<float *> targets;
+      std::vector<size_t> firsts;
+      std::vector<size_t> counts;
+      std::vector<Uint8> loops;
+      std::vector<Track> handles;
+      std::vector<float> keyTimes;
+      std::vector<float> keyValues;
+    };
+
+    Track allocate(Kind pKind, size_t pIndex);
+    void moved(Track pTrack, size_t pIndex);
+
+    SineTracks mSines;
+    TweenTracks mTweens;
+    KeyframeTracks mKeyframes;
+    std::vector<Location> mLocations;
+    std::vector<Track> mFree;
+};
+
+#endif // ANIMATOR_H
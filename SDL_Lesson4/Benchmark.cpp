@@ -0,0 +1,166 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <SDL2/SDL.h>
+
+#include "Constants.h"
+
+namespace {
+  const int DEFAULT_FRAMES = 600;
+
+  double percentile(const std::vector<Uint64> &pSorted, double pFraction) {
+    size_t rank = (size_t)(pFraction * pSorted.size() + 0.5);
+    Uint64 ticks = pSorted[std::min(std::max<size_t>(rank, 1), pSorted.size()) - 1];
+    return 1000.0 * ticks / SDL_GetPerformanceFrequency();
+  }
+}
+
+Benchmark::Benchmark(void) :
+  mEnabled(false),
+  mFrames(DEFAULT_FRAMES),
+  mWidth(0),
+  mHeight(0),
+  mStart(0),
+  mLast(0),
+  mElapsed(0)
+{
+}
+
+bool Benchmark::parse(int argc, char **argv, LessonOptions &pOptions) {
+  for (int i = 1; i < argc; i++) {
+    if (0 == strcmp("--benchmark", argv[i])) {
+      mEnabled = true;
+    } else if (0 == strcmp("--frames", argv[i]) && i + 1 < argc) {
+      mEnabled = true;
+      mFrames = atoi(argv[++i]);
+      if (mFrames <= 0) {
+        return false;
+      }
+    } else if (0 == strcmp("--config", argv[i]) && i + 1 < argc) {
+      mConfigFile = argv[++i];
+    } else if (0 == strcmp("--set", argv[i]) && i + 1 < argc) {
+      mSettings.push_back(argv[++i]);
+    } else if (0 == strcmp("--size", argv[i]) && i + 1 < argc) {
+      if (2 != sscanf(argv[++i], "%dx%d", &mWidth, &mHeight) || mWidth <= 0 || mHeight <= 0) {
+        return false;
+      }
+    } else if (!pOptions.parse(argc, argv, i) && 0 != strncmp("-psn_", argv[i], 5)) {
+      // Anything else is an error, except the process serial number the
+      // macOS Finder passes to bundles.
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Benchmark::prepare(Constants::Config &pConfig) {
+  if (!mConfigFile.empty() && !Constants::LoadConfig(pConfig, mConfigFile)) {
+    return false;
+  }
+  for (const std::string &setting : mSettings) {
+    if (!Constants::Configure(pConfig, setting)) {
+      return false;
+    }
+  }
+  if (0 < mWidth && 0 < mHeight) {
+    pConfig.windowWidth = mWidth;
+    pConfig.windowHeight = mHeight;
+  }
+  // The report reads the resolved size.
+  mWidth = pConfig.windowWidth;
+  mHeight = pConfig.windowHeight;
+  if (mEnabled) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+  }
+  return true;
+}
+
+bool Benchmark::enabled(void) const {
+  return mEnabled;
+}
+
+int Benchmark::frames(void) const {
+  return mFrames;
+}
+
+Uint32 Benchmark::windowFlags(Uint32 pInteractiveFlags) const {
+  return mEnabled ? SDL_WINDOW_HIDDEN : pInteractiveFlags;
+}
+
+Uint32 Benchmark::rendererFlags(Uint32 pInteractiveFlags) const {
+  return mEnabled ? SDL_RENDERER_SOFTWARE : pInteractiveFlags;
+}
+
+void Benchmark::start(void) {
+  mFrameTicks.clear();
+  if (mEnabled) {
+    mFrameTicks.reserve(mFrames);
+  }
+  mStart = SDL_GetPerformanceCounter();
+  mLast = mStart;
+  mElapsed = 0;
+}
+
+bool Benchmark::frameDone(void) {
+  if (!mEnabled) {
+    return false;
+  }
+  Uint64 now = SDL_GetPerformanceCounter();
+  mFrameTicks.push_back(now - mLast);
+  mLast = now;
+  mElapsed = now - mStart;
+  return (int)mFrameTicks.size() >= mFrames;
+}
+
+void Benchmark::report(std::ostream &pOutputStream, const char *pName, const LessonOptions &pOptions, const FrameProfiler &pProfiler) const {
+  if (mFrameTicks.empty()) {
+    return;
+  }
+  std::vector<Uint64> sorted(mFrameTicks);
+  std::sort(sorted.begin(), sorted.end());
+  double seconds = (double)mElapsed / SDL_GetPerformanceFrequency();
+
+  pOutputStream << std::fixed << std::setprecision(3)
+    << "{\"lesson\":\"" << pName << "\""
+    << ",\"renderer\":\"software\""
+    << ",\"threads\":" << (pOptions.cpuBlit() ? pOptions.threads() : 1)
+    << ",\"width\":" << mWidth
+    << ",\"height\":" << mHeight
+    << ",\"frames\":" << mFrameTicks.size()
+    << ",\"seconds\":" << seconds
+    << ",\"fps\":" << mFrameTicks.size() / seconds
+    << ",\"frame_ms\":{"
+    << "\"mean\":" << 1000.0 * seconds / mFrameTicks.size()
+    << ",\"p50\":" << percentile(sorted, 0.50)
+    << ",\"p95\":" << percentile(sorted, 0.95)
+    << ",\"p99\":" << percentile(sorted, 0.99)
+    << ",\"max\":" << percentile(sorted, 1.0)
+    << "},\"phases_ms\":{";
+  bool first = true;
+  for (int i = 0; i < (int)FramePhase::Count; i++) {
+    FrameProfiler::Summary phase = pProfiler.summary((FramePhase)i);
+    if (0 == phase.samples) {
+      continue;
+    }
+    pOutputStream << (first ? "" : ",")
+      << "\"" << FrameProfiler::name((FramePhase)i) << "\":{"
+      << "\"p50\":" << phase.p50
+      << ",\"p95\":" << phase.p95
+      << ",\"p99\":" << phase.p99
+      << ",\"max\":" << phase.max << "}";
+    first = false;
+  }
+  pOutputStream << "}}" << std::endl;
+}
+
+void Benchmark::usage(std::ostream &pOutputStream, const char *pName, const LessonOptions &pOptions) {
+  pOutputStream << "Usage: " << pName << " [--benchmark] [--frames N] [--size WIDTHxHEIGHT] [--config FILE] [--set KEY=VALUE]";
+  pOptions.usage(pOutputStream);
+  pOutputStream << std::endl;
+}
@@ -1,10 +1,36 @@
 #include "Constants.h"
 
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <SDL2/SDL.h>
 
 namespace Constants {
+  namespace {
+    struct Setting {
+      const char *key;
+      int Config::*field;
+      int minimum;
+      int maximum;
+    };
+
+    const Setting SETTINGS[] = {
+      {"window_width", &Config::windowWidth, 1, 16384},
+      {"window_height", &Config::windowHeight, 1, 16384},
+      {"frames_per_second", &Config::framesPerSecond, 1, 1000},
+      {"tile_size", &Config::tileSize, 1, 4096},
+    };
+
+    std::string trim(const std::string &pText) {
+      size_t first = pText.find_first_not_of(" \t\r");
+      if (std::string::npos == first) {
+        return "";
+      }
+      return pText.substr(first, pText.find_last_not_of(" \t\r") - first + 1);
+    }
+  }
+
   char const * const ApplicationName(void) {
     static const char result[] = "SDL_Lesson3"; // intentional
     return result;
@@ -35,29 +61,68 @@ namespace Constants {
     }
     return directory.empty() ? basePath : basePath + directory + PATH_SEP;
   }
+  std::string ResourcePackPath(void) {
+    std::string resourcePath = ResourcePath("");
+    // ".../res/" becomes ".../res.pack"
+    return resourcePath.empty() ? "" : resourcePath.substr(0, resourcePath.size() - 1) + ".pack";
+  }
+  std::string ImageCachePath(void) {
+    std::string resourcePath = ResourcePath("");
+    // ".../res/" becomes ".../cache/"
+    return resourcePath.empty() ? "" : resourcePath.substr(0, resourcePath.size() - 4) + "cache" + resourcePath.substr(resourcePath.size() - 1);
+  }
   int WindowPositionX(void) {
     return SDL_WINDOWPOS_CENTERED;
   }
   int WindowPositionY(void) {
     return SDL_WINDOWPOS_CENTERED;
   }
-  int WindowWidth(void) {
-    return 640;
-  }
-  int WindowHeight(void) {
-    return 480;
-  }
   int DefaultRendererWindow(void) {
     return -1;
   }
-  int FramesPerSecond(void) {
-    return 60;
-  }
-  int FrameWait(void) {
-    return 1000 / FramesPerSecond();
+  bool Configure(Config &pConfig, const std::string &pSetting) {
+    size_t separator = pSetting.find('=');
+    if (std::string::npos == separator) {
+      SDL_SetError("Expected key=value: %s", pSetting.c_str());
+      return false;
+    }
+    std::string key = trim(pSetting.substr(0, separator));
+    std::string value = trim(pSetting.substr(separator + 1));
+    for (const Setting &setting : SETTINGS) {
+      if (key != setting.key) {
+        continue;
+      }
+      char *end = nullptr;
+      long number = strtol(value.c_str(), &end, 10);
+      if (value.empty() || '\0' != *end || number < setting.minimum || number > setting.maximum) {
+        SDL_SetError("%s must be between %d and %d: %s", setting.key, setting.minimum, setting.maximum, value.c_str());
+        return false;
+      }
+      pConfig.*setting.field = (int)number;
+      return true;
+    }
+    SDL_SetError("Unknown setting: %s", key.c_str());
+    return false;
   }
-  int TileSize(void) {
-    return 64;
+  bool LoadConfig(Config &pConfig, const std::string &pFileName) {
+    std::ifstream file(pFileName);
+    if (!file) {
+      SDL_SetError("Couldn't open %s", pFileName.c_str());
+      return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+      lineNumber++;
+      line = trim(line.substr(0, line.find('#')));
+      if (!line.empty() && !Configure(pConfig, line)) {
+        // SDL_SetError may not format its own message into itself.
+        std::string error = SDL_GetError();
+        SDL_SetError("%s:%d: %s", pFileName.c_str(), lineNumber, error.c_str());
+        return false;
+      }
+    }
+    return true;
   }
 }
 
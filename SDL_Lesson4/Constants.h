@@ -4,17 +4,38 @@
 #include <string>
 
 namespace Constants {
+  // Compile-time defaults for the values the frame loop reads.
+  constexpr int DEFAULT_WINDOW_WIDTH = 640;
+  constexpr int DEFAULT_WINDOW_HEIGHT = 480;
+  constexpr int DEFAULT_FRAMES_PER_SECOND = 60;
+  constexpr int DEFAULT_TILE_SIZE = 64;
+
+  /*
+   * Run-time settings, resolved once at startup and then read directly by
+   * the frame loop.  Each starts at its default above; LoadConfig() and
+   * Configure() override them from a file and the command line.
+   */
+  struct Config {
+    int windowWidth = DEFAULT_WINDOW_WIDTH;
+    int windowHeight = DEFAULT_WINDOW_HEIGHT;
+    int framesPerSecond = DEFAULT_FRAMES_PER_SECOND;
+    int tileSize = DEFAULT_TILE_SIZE;
+  };
+
   extern char const * const ApplicationName(void);
   extern std::string ResourcePath(const std::string &subDir);
+  extern std::string ResourcePackPath(void);
+  extern std::string ImageCachePath(void);
   extern char const * const WindowTitle(void);
   extern int WindowPositionX(void);
   extern int WindowPositionY(void);
-  extern int WindowWidth(void);
-  extern int WindowHeight(void);
   extern int DefaultRendererWindow(void);
-  extern int FramesPerSecond(void);
-  extern int FrameWait(void);
-  extern int TileSize(void);
+  // Applies one "key=value" setting, such as "window_width=1280".  Returns
+  // false, with SDL_GetError set, for an unknown key or a bad value.
+  extern bool Configure(Config &pConfig, const std::string &pSetting);
+  // Applies a file of settings, one per line; blank lines and text after a
+  // '#' are ignored.
+  extern bool LoadConfig(Config &pConfig, const std::string &pFileName);
 };
 
 #endif // CONSTANTS_H
@@ -0,0 +1,83 @@
+#ifndef CPU_CANVAS_H
+#define CPU_CANVAS_H
+
+#include <map>
+#include <memory>
+#include <SDL2/SDL.h>
+
+#include "SoftwareBlitter.h"
+#include "TileRasterizer.h"
+
+/*
+ * Optional CPU rendering backend.  Between begin() and end() the canvas is
+ * current for its renderer and renderTexture draws into a framebuffer in
+ * system memory with SoftwareBlitter instead of SDL_RenderCopy; end()
+ * uploads the framebuffer through one streaming texture.  Textures are read
+ * back on first use and kept as surfaces until forget() or clear(), except
+ * streaming ones, which are read back again the first time they are drawn in
+ * each frame.  With more than one thread the frame's draws are recorded
+ * instead and rasterised in parallel screen tiles at end().  A draw the CPU
+ * cannot do uploads the framebuffer there and then, and the renderer draws
+ * the rest of the frame, so the order of the draws holds.  Without create()
+ * begin() and end() do nothing.
+ */
+class CpuCanvas {
+  public:
+    explicit CpuCanvas(SDL_Renderer *pRenderer);
+    ~CpuCanvas(void);
+    CpuCanvas(const CpuCanvas &) = delete;
+    CpuCanvas &operator=(const CpuCanvas &) = delete;
+
+    // Returns false and leaves SDL_GetError set if the framebuffer cannot be
+    // created.  pThreads other than 1 selects tiled rendering; 0 uses one
+    // thread per CPU.
+    bool create(int pWidth, int pHeight, ScaleFilter pFilter = ScaleFilter::Nearest, int pThreads = 1);
+    bool ready(void) const;
+
+    // Clears the framebuffer to the renderer's draw colour.
+    void begin(void);
+    void end(void);
+    // Returns false if the copy cannot be done on the CPU (an unsupported
+    // blend mode, colour or alpha modulation, or a failed read-back), or an
+    // earlier one this frame could not; the caller should then draw it with
+    // the renderer.
+    bool draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip = nullptr);
+
+    // Drops the CPU copy of pTexture; call before destroying it or changing
+    // a static or target texture, and not between begin() and end().
+    void forget(SDL_Texture *pTexture);
+    void clear(void);
+    SoftwareBlitter &blitter(void);
+    // Threads rasterising each frame; 1 when drawing directly.
+    int threads(void) const;
+
+    // The canvas between begin() and end() for pRenderer, or nullptr.
+    static CpuCanvas *current(SDL_Renderer *pRenderer);
+
+  private:
+    struct Snapshot {
+      SDL_Surface *surface;
+      bool streaming;
+      Uint64 frame;
+    };
+
+    SDL_Surface *snapshot(SDL_Texture *pTexture);
+    bool readBack(SDL_Texture *pTexture, Snapshot &pSnapshot);
+    // Copies the framebuffer drawn so far to the renderer.
+    void present(void);
+
+    SDL_Renderer *mRenderer;
+    SDL_Surface *mFramebuffer;
+    SDL_Texture *mTexture;
+    ScaleFilter mFilter;
+    SoftwareBlitter mBlitter;
+    std::unique_ptr<TileRasterizer> mTiles;
+    std::map<SDL_Texture *, Snapshot> mSnapshots;
+    Uint64 mFrame;
+    // Set once a draw falls back to the renderer, until end().
+    bool mSuspended;
+
+    static CpuCanvas *sCurrent;
+};
+
+#endif // CPU_CANVAS_H
@@ -0,0 +1,106 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <vector>
+#include <SDL2/SDL.h>
+
+namespace {
+  double percentile(const std::vector<Uint32> &pSorted, double pFraction) {
+    size_t rank = (size_t)(pFraction * pSorted.size() + 0.5);
+    return pSorted[std::min(std::max<size_t>(rank, 1), pSorted.size()) - 1] / 1000.0;
+  }
+}
+
+FrameProfiler::FrameProfiler(void) :
+  mFrequency(SDL_GetPerformanceFrequency()),
+  mLast(SDL_GetPerformanceCounter())
+{
+  for (Ring &ring : mRings) {
+    for (std::atomic<Uint32> &sample : ring.samples) {
+      sample.store(0, std::memory_order_relaxed);
+    }
+    ring.written.store(0, std::memory_order_relaxed);
+  }
+}
+
+void FrameProfiler::beginFrame(void) {
+  mLast = SDL_GetPerformanceCounter();
+}
+
+void FrameProfiler::mark(FramePhase pPhase) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  record(pPhase, now - mLast);
+  mLast = now;
+}
+
+void FrameProfiler::record(FramePhase pPhase, Uint64 pTicks) {
+  Ring &ring = mRings[(size_t)pPhase];
+  Uint64 microseconds = pTicks * 1000000 / mFrequency;
+  Uint64 written = ring.written.load(std::memory_order_relaxed);
+  ring.samples[written % RING_SIZE].store(
+    (Uint32)std::min<Uint64>(microseconds, std::numeric_limits<Uint32>::max()),
+    std::memory_order_relaxed
+  );
+  ring.written.store(written + 1, std::memory_order_release);
+}
+
+FrameProfiler::Summary FrameProfiler::summary(FramePhase pPhase) const {
+  const Ring &ring = mRings[(size_t)pPhase];
+  Summary result = {0, 0.0, 0.0, 0.0, 0.0};
+  size_t count = std::min<Uint64>(ring.written.load(std::memory_order_acquire), (Uint64)RING_SIZE);
+  if (0 == count) {
+    return result;
+  }
+  std::vector<Uint32> sorted(count);
+  for (size_t i = 0; i < count; i++) {
+    sorted[i] = ring.samples[i].load(std::memory_order_relaxed);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  result.samples = count;
+  result.p50 = percentile(sorted, 0.50);
+  result.p95 = percentile(sorted, 0.95);
+  result.p99 = percentile(sorted, 0.99);
+  result.max = sorted.back() / 1000.0;
+  return result;
+}
+
+void FrameProfiler::report(std::ostream &pOutputStream) const {
+  pOutputStream << std::setw(12) << "phase"
+    << std::setw(9) << "samples"
+    << std::setw(10) << "p50 ms"
+    << std::setw(10) << "p95 ms"
+    << std::setw(10) << "p99 ms"
+    << std::setw(10) << "max ms" << std::endl;
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    Summary phase = summary((FramePhase)i);
+    if (0 == phase.samples) {
+      continue;
+    }
+    pOutputStream << std::setw(12) << name((FramePhase)i)
+      << std::setw(9) << phase.samples
+      << std::fixed << std::setprecision(3)
+      << std::setw(10) << phase.p50
+      << std::setw(10) << phase.p95
+      << std::setw(10) << phase.p99
+      << std::setw(10) << phase.max << std::endl;
+  }
+}
+
+const char *FrameProfiler::name(FramePhase pPhase) {
+  switch (pPhase) {
+    case FramePhase::Events:
+      return "events";
+    case FramePhase::Clear:
+      return "clear";
+    case FramePhase::Background:
+      return "background";
+    case FramePhase::Sprites:
+      return "sprites";
+    case FramePhase::Present:
+      return "present";
+    default:
+      return "unknown";
+  }
+}
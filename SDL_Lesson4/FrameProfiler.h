@@ -0,0 +1,64 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <SDL2/SDL.h>
+
+enum class FramePhase {
+  Events,
+  Clear,
+  Background,
+  Sprites,
+  Present,
+  Count
+};
+
+/*
+ * Times each phase of the main loop into a per-phase ring of the most recent
+ * samples.  The render thread is the only writer and publishes each sample
+ * with a release store, so summary() and report() can be called at any time,
+ * from any thread, without locking the loop.
+ */
+class FrameProfiler {
+  public:
+    // Percentiles over the samples currently in the ring, in milliseconds.
+    struct Summary {
+      size_t samples;
+      double p50;
+      double p95;
+      double p99;
+      double max;
+    };
+
+    FrameProfiler(void);
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+    // Starts timing a frame; the first mark() measures from here.
+    void beginFrame(void);
+    // Charges the time since the previous mark (or beginFrame) to pPhase.
+    void mark(FramePhase pPhase);
+    void record(FramePhase pPhase, Uint64 pTicks);
+
+    Summary summary(FramePhase pPhase) const;
+    void report(std::ostream &pOutputStream) const;
+    static const char *name(FramePhase pPhase);
+
+  private:
+    static const size_t RING_SIZE = 1024;
+    static const size_t PHASE_COUNT = (size_t)FramePhase::Count;
+
+    struct Ring {
+      // Sample durations in microseconds.
+      std::atomic<Uint32> samples[RING_SIZE];
+      std::atomic<Uint64> written;
+    };
+
+    Ring mRings[PHASE_COUNT];
+    Uint64 mFrequency;
+    Uint64 mLast;
+};
+
+#endif // FRAME_PROFILER_H
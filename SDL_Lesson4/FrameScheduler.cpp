@@ -0,0 +1,122 @@
+#include "FrameScheduler.h"
+
+#include <SDL2/SDL.h>
+
+namespace {
+  // SDL_Delay can oversleep by a scheduler tick; spin for the remainder.
+  const Uint64 SPIN_MICROSECONDS = 2000;
+  const Uint64 NEVER = ~(Uint64)0;
+}
+
+FrameScheduler::FrameScheduler(int pFramesPerSecond, FrameMode pMode) :
+  mMode(pMode),
+  mFrequency(SDL_GetPerformanceFrequency()),
+  mPeriod(mFrequency / pFramesPerSecond),
+  mStart(SDL_GetPerformanceCounter()),
+  mFrameStart(mStart),
+  mDeadline(mStart + mPeriod),
+  mLastFrame(0),
+  mNow(mStart),
+  mEventDriven(false),
+  mInvalid(true),
+  mWake(NEVER)
+{
+}
+
+double FrameScheduler::seconds(Uint64 pTicks) const {
+  return (double)pTicks / mFrequency;
+}
+
+void FrameScheduler::beginFrame(void) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  mLastFrame = now - mFrameStart;
+  mFrameStart = now;
+  mNow = now - mStart;
+}
+
+void FrameScheduler::endFrame(void) {
+  if (mEventDriven) {
+    bool rendered = pending();
+    mInvalid = false;
+    if (mWake <= mNow) {
+      mWake = NEVER;
+    }
+    if (!rendered) {
+      // Nothing was drawn; waitForWork() does the waiting.
+      return;
+    }
+  }
+  if (FrameMode::Uncapped == mMode) {
+    return;
+  }
+  Uint64 now = SDL_GetPerformanceCounter();
+  if (mDeadline + mPeriod < now) {
+    // More than a whole frame late: restart the cadence from now.
+    mDeadline = now + mPeriod;
+    return;
+  }
+  Uint64 spin = SPIN_MICROSECONDS * mFrequency / 1000000;
+  if (now + spin < mDeadline) {
+    SDL_Delay((Uint32)((mDeadline - spin - now) * 1000 / mFrequency));
+  }
+  while (SDL_GetPerformanceCounter() < mDeadline) {
+  }
+  mDeadline += mPeriod;
+}
+
+double FrameScheduler::time(void) const {
+  return seconds(mNow);
+}
+
+double FrameScheduler::frameSeconds(void) const {
+  return seconds(mLastFrame);
+}
+
+FrameMode FrameScheduler::mode(void) const {
+  return mMode;
+}
+
+void FrameScheduler::setMode(FrameMode pMode) {
+  mMode = pMode;
+  mDeadline = SDL_GetPerformanceCounter() + mPeriod;
+}
+
+bool FrameScheduler::eventDriven(void) const {
+  return mEventDriven;
+}
+
+void FrameScheduler::setEventDriven(bool pEnabled) {
+  mEventDriven = pEnabled;
+  mInvalid = true;
+}
+
+void FrameScheduler::invalidate(void) {
+  mInvalid = true;
+}
+
+void FrameScheduler::wakeAt(double pSeconds) {
+  Uint64 ticks = 0.0 < pSeconds ? (Uint64)(pSeconds * mFrequency) : 0;
+  mWake = ticks < mWake ? ticks : mWake;
+}
+
+bool FrameScheduler::pending(void) const {
+  return !mEventDriven || mInvalid || mWake <= mNow;
+}
+
+void FrameScheduler::waitForWork(void) {
+  if (!mEventDriven || mInvalid) {
+    return;
+  }
+  Uint64 now = SDL_GetPerformanceCounter() - mStart;
+  if (mWake <= now) {
+    return;
+  }
+  int timeout = -1;
+  if (NEVER != mWake) {
+    // Round up so the deadline has passed when the wait times out.
+    timeout = (int)((mWake - now) * 1000 / mFrequency) + 1;
+  }
+  SDL_WaitEventTimeout(nullptr, timeout);
+  // Restart the cadence rather than catch up on the frames slept through.
+  mDeadline = SDL_GetPerformanceCounter() + mPeriod;
+}
@@ -0,0 +1,65 @@
+#include "LessonOptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <SDL2/SDL.h>
+
+LessonOptions::LessonOptions(Uint32 pSupported) :
+  mSupported(pSupported),
+  mRetained(false),
+  mCpuBlit(false),
+  mThreads(1),
+  mIdle(false)
+{
+}
+
+bool LessonOptions::parse(int argc, char **argv, int &pIndex) {
+  const char *option = argv[pIndex];
+  if (0 != (mSupported & RETAINED) && 0 == strcmp("--retained", option)) {
+    mRetained = true;
+  } else if (0 != (mSupported & CPU_BLIT) && 0 == strcmp("--cpu-blit", option)) {
+    mCpuBlit = true;
+  } else if (0 != (mSupported & CPU_BLIT) && 0 == strcmp("--threads", option) && pIndex + 1 < argc) {
+    int threads = atoi(argv[pIndex + 1]);
+    if (threads < 0) {
+      return false;
+    }
+    mCpuBlit = true;
+    mThreads = threads;
+    pIndex++;
+  } else if (0 != (mSupported & IDLE) && 0 == strcmp("--idle", option)) {
+    mIdle = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool LessonOptions::retained(void) const {
+  return mRetained;
+}
+
+bool LessonOptions::cpuBlit(void) const {
+  return mCpuBlit;
+}
+
+int LessonOptions::threads(void) const {
+  return 0 < mThreads ? mThreads : std::max(1, SDL_GetCPUCount());
+}
+
+bool LessonOptions::idle(void) const {
+  return mIdle;
+}
+
+void LessonOptions::usage(std::ostream &pOutputStream) const {
+  if (0 != (mSupported & RETAINED)) {
+    pOutputStream << " [--retained]";
+  }
+  if (0 != (mSupported & CPU_BLIT)) {
+    pOutputStream << " [--cpu-blit] [--threads N]";
+  }
+  if (0 != (mSupported & IDLE)) {
+    pOutputStream << " [--idle]";
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef RESOURCE_PACK_H
+#define RESOURCE_PACK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * Pack file layout, little-endian:
+ *   PackHeader
+ *   asset data, each blob aligned to PACK_ALIGNMENT
+ *   PackEntry index sorted by hash, at indexOffset
+ *   entry names, at namesOffset
+ * Names are paths relative to the packed res/ directory with '/' separators.
+ */
+const char PACK_MAGIC[8] = {'S', 'D', 'L', 'P', 'A', 'C', 'K', '1'};
+const Uint32 PACK_VERSION = 1;
+const Uint64 PACK_ALIGNMENT = 64;
+
+struct PackHeader {
+  char magic[8];
+  Uint32 version;
+  Uint32 entryCount;
+  Uint64 indexOffset;
+  Uint64 namesOffset;
+};
+
+struct PackEntry {
+  Uint64 hash;
+  Uint64 offset;
+  Uint64 size;
+  Uint32 nameOffset;
+  Uint32 nameLength;
+};
+
+// 64-bit FNV-1a, shared by the pack tool and the reader.
+inline Uint64 packHash(const void *pData, size_t pSize) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(pData);
+  Uint64 result = 14695981039346656037ULL;
+  for (size_t i = 0; i < pSize; i++) {
+    result = (result ^ bytes[i]) * 1099511628211ULL;
+  }
+  return result;
+}
+
+inline Uint64 packHash(const std::string &pName) {
+  return packHash(pName.data(), pName.size());
+}
+
+/*
+ * Read-only view of a pack file mapped into memory.  Assets are served
+ * straight from the mapping, so pointers and RWops stay valid until
+ * close().  Paths may be given relative to the pack or as full paths
+ * under the root directory passed to open().
+ */
+class ResourcePack {
+  public:
+    ResourcePack(void);
+    ~ResourcePack(void);
+    ResourcePack(const ResourcePack &) = delete;
+    ResourcePack &operator=(const ResourcePack &) = delete;
+
+    // Returns false and leaves SDL_GetError set if the pack is unusable.
+    bool open(const std::string &pPackPath, const std::string &pRoot = "");
+    void close(void);
+    bool isOpen(void) const;
+    // Pointer into the mapping, or nullptr if pPath is not packed.
+    const void *find(const std::string &pPath, size_t *pSize) const;
+    // A read-only SDL_RWops over the mapped bytes, or nullptr.
+    SDL_RWops *openRW(const std::string &pPath) const;
+    // File names directly inside pDirectory, sorted.
+    std::vector<std::string> list(const std::string &pDirectory) const;
+
+  private:
+    std::string relative(const std::string &pPath) const;
+
+    const unsigned char *mData;
+    size_t mSize;
+    const PackEntry *mEntries;
+    Uint32 mEntryCount;
+    const char *mNames;
+    std::string mRoot;
+    #ifdef _WIN32
+      void *mFile;
+      void *mMapping;
+    #endif
+};
+
+#endif // RESOURCE_PACK_H
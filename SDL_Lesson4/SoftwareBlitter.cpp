@@ -0,0 +1,399 @@
+#include "SoftwareBlitter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <SDL2/SDL.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #define SOFTWARE_BLITTER_X86 1
+  #include <immintrin.h>
+  #if defined(__GNUC__) || defined(__clang__)
+    #define TARGET_SSE2 __attribute__((target("sse2")))
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+  #else
+    #define TARGET_SSE2
+    #define TARGET_AVX2
+  #endif
+#else
+  #define SOFTWARE_BLITTER_X86 0
+#endif
+
+namespace {
+  const Uint32 ALPHA_MASK = 0xFF000000;
+
+  Uint32 *pixelRow(SDL_Surface *pSurface, int pY) {
+    return reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(pSurface->pixels) + pY * pSurface->pitch);
+  }
+
+  // Exact x / 255 for x in [0, 255 * 255].
+  inline Uint32 divide255(Uint32 pValue) {
+    Uint32 rounded = pValue + 128;
+    return (rounded + (rounded >> 8)) >> 8;
+  }
+
+  // out = (src' * a + dst * (255 - a)) / 255 per channel, where src' is the
+  // source with its alpha forced to 255; for the alpha channel this gives
+  // a + dstA * (255 - a) / 255.
+  void blendRowScalar(const Uint32 *pSource, Uint32 *pDestination, int pCount) {
+    for (int i = 0; i < pCount; i++) {
+      Uint32 source = pSource[i];
+      Uint32 alpha = source >> 24;
+      if (0 == alpha) {
+        continue;
+      }
+      if (0xFF == alpha) {
+        pDestination[i] = source;
+        continue;
+      }
+      source |= ALPHA_MASK;
+      Uint32 destination = pDestination[i];
+      Uint32 result = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        Uint32 s = (source >> shift) & 0xFF;
+        Uint32 d = (destination >> shift) & 0xFF;
+        result |= divide255(s * alpha + d * (255 - alpha)) << shift;
+      }
+      pDestination[i] = result;
+    }
+  }
+
+  void fillRowScalar(Uint32 *pDestination, int pCount, Uint32 pColor) {
+    std::fill(pDestination, pDestination + pCount, pColor);
+  }
+
+  // Two-pass 8.8 fixed-point filter: vertical with pWeightY, then horizontal
+  // with each column's weight (0-256), rounding after each pass.
+  void bilinearRowScalar(
+    const Uint32 *pTop,
+    const Uint32 *pBottom,
+    int pWeightY,
+    const int *pColumns,
+    const int *pWeightsX,
+    Uint32 *pOutput,
+    int pCount
+  ) {
+    for (int i = 0; i < pCount; i++) {
+      int column = pColumns[i];
+      int weightX = pWeightsX[i];
+      Uint32 result = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        int left = ((int)((pTop[column] >> shift) & 0xFF) * (256 - pWeightY)
+          + (int)((pBottom[column] >> shift) & 0xFF) * pWeightY + 128) >> 8;
+        int right = ((int)((pTop[column + 1] >> shift) & 0xFF) * (256 - pWeightY)
+          + (int)((pBottom[column + 1] >> shift) & 0xFF) * pWeightY + 128) >> 8;
+        result |= (Uint32)((left * (256 - weightX) + right * weightX + 128) >> 8) << shift;
+      }
+      pOutput[i] = result;
+    }
+  }
+
+  #if SOFTWARE_BLITTER_X86
+    TARGET_SSE2 inline __m128i divide255Sse2(__m128i pValue) {
+      __m128i rounded = _mm_add_epi16(pValue, _mm_set1_epi16(128));
+      return _mm_srli_epi16(_mm_add_epi16(rounded, _mm_srli_epi16(rounded, 8)), 8);
+    }
+
+    TARGET_SSE2 void blendRowSse2(const Uint32 *pSource, Uint32 *pDestination, int pCount) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i alphaMask = _mm_set1_epi32((int)ALPHA_MASK);
+      const __m128i full = _mm_set1_epi16(255);
+      int i = 0;
+      for (; i + 4 <= pCount; i += 4) {
+        __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource + i));
+        __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDestination + i));
+        // Alpha of each pixel repeated across its four 16-bit channels.
+        __m128i alpha = _mm_srli_epi32(source, 24);
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+        __m128i alphaLow = _mm_unpacklo_epi32(alpha, alpha);
+        __m128i alphaHigh = _mm_unpackhi_epi32(alpha, alpha);
+        source = _mm_or_si128(source, alphaMask);
+
+        __m128i low = _mm_add_epi16(
+          _mm_mullo_epi16(_mm_unpacklo_epi8(source, zero), alphaLow),
+          _mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), _mm_sub_epi16(full, alphaLow))
+        );
+        __m128i high = _mm_add_epi16(
+          _mm_mullo_epi16(_mm_unpackhi_epi8(source, zero), alphaHigh),
+          _mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), _mm_sub_epi16(full, alphaHigh))
+        );
+        __m128i result = _mm_packus_epi16(divide255Sse2(low), divide255Sse2(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pDestination + i), result);
+      }
+      blendRowScalar(pSource + i, pDestination + i, pCount - i);
+    }
+
+    TARGET_SSE2 void fillRowSse2(Uint32 *pDestination, int pCount, Uint32 pColor) {
+      const __m128i color = _mm_set1_epi32((int)pColor);
+      int i = 0;
+      for (; i + 4 <= pCount; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pDestination + i), color);
+      }
+      fillRowScalar(pDestination + i, pCount - i, pColor);
+    }
+
+    TARGET_SSE2 void bilinearRowSse2(
+      const Uint32 *pTop,
+      const Uint32 *pBottom,
+      int pWeightY,
+      const int *pColumns,
+      const int *pWeightsX,
+      Uint32 *pOutput,
+      int pCount
+    ) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i half = _mm_set1_epi16(128);
+      const __m128i weightBottom = _mm_set1_epi16((short)pWeightY);
+      const __m128i weightTop = _mm_set1_epi16((short)(256 - pWeightY));
+      for (int i = 0; i < pCount; i++) {
+        int column = pColumns[i];
+        short weightRight = (short)pWeightsX[i];
+        short weightLeft = (short)(256 - pWeightsX[i]);
+        // Left pixel in the low four lanes, right pixel in the high four.
+        __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pTop + column)), zero);
+        __m128i bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pBottom + column)), zero);
+        __m128i vertical = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+          _mm_mullo_epi16(top, weightTop),
+          _mm_mullo_epi16(bottom, weightBottom)), half), 8);
+        __m128i weights = _mm_set_epi16(
+          weightRight, weightRight, weightRight, weightRight,
+          weightLeft, weightLeft, weightLeft, weightLeft
+        );
+        __m128i horizontal = _mm_mullo_epi16(vertical, weights);
+        horizontal = _mm_add_epi16(horizontal, _mm_srli_si128(horizontal, 8));
+        horizontal = _mm_srli_epi16(_mm_add_epi16(horizontal, half), 8);
+        pOutput[i] = (Uint32)_mm_cvtsi128_si32(_mm_packus_epi16(horizontal, zero));
+      }
+    }
+
+    TARGET_AVX2 inline __m256i divide255Avx2(__m256i pValue) {
+      __m256i rounded = _mm256_add_epi16(pValue, _mm256_set1_epi16(128));
+      return _mm256_srli_epi16(_mm256_add_epi16(rounded, _mm256_srli_epi16(rounded, 8)), 8);
+    }
+
+    TARGET_AVX2 void blendRowAvx2(const Uint32 *pSource, Uint32 *pDestination, int pCount) {
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i alphaMask = _mm256_set1_epi32((int)ALPHA_MASK);
+      const __m256i full = _mm256_set1_epi16(255);
+      int i = 0;
+      for (; i + 8 <= pCount; i += 8) {
+        __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSource + i));
+        __m256i destination = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pDestination + i));
+        // Unpacks work within each 128-bit half, so the layout matches SSE2.
+        __m256i alpha = _mm256_srli_epi32(source, 24);
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+        __m256i alphaLow = _mm256_unpacklo_epi32(alpha, alpha);
+        __m256i alphaHigh = _mm256_unpackhi_epi32(alpha, alpha);
+        source = _mm256_or_si256(source, alphaMask);
+
+        __m256i low = _mm256_add_epi16(
+          _mm256_mullo_epi16(_mm256_unpacklo_epi8(source, zero), alphaLow),
+          _mm256_mullo_epi16(_mm256_unpacklo_epi8(destination, zero), _mm256_sub_epi16(full, alphaLow))
+        );
+        __m256i high = _mm256_add_epi16(
+          _mm256_mullo_epi16(_mm256_unpackhi_epi8(source, zero), alphaHigh),
+          _mm256_mullo_epi16(_mm256_unpackhi_epi8(destination, zero), _mm256_sub_epi16(full, alphaHigh))
+        );
+        __m256i result = _mm256_packus_epi16(divide255Avx2(low), divide255Avx2(high));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(pDestination + i), result);
+      }
+      blendRowSse2(pSource + i, pDestination + i, pCount - i);
+    }
+
+    TARGET_AVX2 void fillRowAvx2(Uint32 *pDestination, int pCount, Uint32 pColor) {
+      const __m256i color = _mm256_set1_epi32((int)pColor);
+      int i = 0;
+      for (; i + 8 <= pCount; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(pDestination + i), color);
+      }
+      fillRowScalar(pDestination + i, pCount - i, pColor);
+    }
+  #endif
+
+  // Maps destination offset pOffset of pDestinationSize onto the source in
+  // 8.8 fixed point, sampling at pixel centres.
+  int sourceCoordinate(int pOffset, int pSourceSize, int pDestinationSize) {
+    return (int)(((2 * (Sint64)pOffset + 1) * pSourceSize * 256) / (2 * (Sint64)pDestinationSize)) - 128;
+  }
+}
+
+SoftwareBlitter::SoftwareBlitter(void) :
+  mLevel(BlitLevel::Scalar),
+  mBlendRow(blendRowScalar),
+  mFillRow(fillRowScalar),
+  mBilinearRow(bilinearRowScalar)
+{
+  setLevel(detect());
+}
+
+BlitLevel SoftwareBlitter::detect(void) {
+  #if SOFTWARE_BLITTER_X86
+    if (SDL_HasAVX2()) {
+      return BlitLevel::AVX2;
+    }
+    if (SDL_HasSSE2()) {
+      return BlitLevel::SSE2;
+    }
+  #endif
+  return BlitLevel::Scalar;
+}
+
+const char *SoftwareBlitter::name(BlitLevel pLevel) {
+  switch (pLevel) {
+    case BlitLevel::AVX2:
+      return "avx2";
+    case BlitLevel::SSE2:
+      return "sse2";
+    case BlitLevel::Scalar:
+    default:
+      return "scalar";
+  }
+}
+
+bool SoftwareBlitter::setLevel(BlitLevel pLevel) {
+  if ((int)detect() < (int)pLevel) {
+    return false;
+  }
+  mLevel = pLevel;
+  switch (pLevel) {
+    #if SOFTWARE_BLITTER_X86
+      case BlitLevel::AVX2:
+        mBlendRow = blendRowAvx2;
+        mFillRow = fillRowAvx2;
+        mBilinearRow = bilinearRowSse2;
+        break;
+      case BlitLevel::SSE2:
+        mBlendRow = blendRowSse2;
+        mFillRow = fillRowSse2;
+        mBilinearRow = bilinearRowSse2;
+        break;
+    #endif
+    default:
+      mBlendRow = blendRowScalar;
+      mFillRow = fillRowScalar;
+      mBilinearRow = bilinearRowScalar;
+      break;
+  }
+  return true;
+}
+
+BlitLevel SoftwareBlitter::level(void) const {
+  return mLevel;
+}
+
+void SoftwareBlitter::writeRow(const Uint32 *pSource, Uint32 *pDestination, int pCount, bool pBlend) const {
+  if (pBlend) {
+    mBlendRow(pSource, pDestination, pCount);
+  } else {
+    memcpy(pDestination, pSource, pCount * sizeof(Uint32));
+  }
+}
+
+bool SoftwareBlitter::blit(
+  SDL_Surface *pSource,
+  const SDL_Rect *pSourceRect,
+  SDL_Surface *pDestination,
+  const SDL_Rect *pDestinationRect,
+  ScaleFilter pFilter,
+  bool pBlend
+) {
+  if (SDL_PIXELFORMAT_ARGB8888 != pSource->format->format || SDL_PIXELFORMAT_ARGB8888 != pDestination->format->format) {
+    SDL_SetError("SoftwareBlitter needs ARGB8888 surfaces");
+    return false;
+  }
+  SDL_Rect sourceBounds = {0, 0, pSource->w, pSource->h};
+  SDL_Rect source = sourceBounds;
+  if (nullptr != pSourceRect && !SDL_IntersectRect(pSourceRect, &sourceBounds, &source)) {
+    return true;
+  }
+  SDL_Rect destination = {0, 0, pDestination->w, pDestination->h};
+  if (nullptr != pDestinationRect) {
+    destination = *pDestinationRect;
+  }
+  SDL_Rect visible;
+  if (!SDL_IntersectRect(&destination, &pDestination->clip_rect, &visible)) {
+    return true;
+  }
+  if (SDL_MUSTLOCK(pSource)) {
+    SDL_LockSurface(pSource);
+  }
+  if (SDL_MUSTLOCK(pDestination)) {
+    SDL_LockSurface(pDestination);
+  }
+
+  if (source.w == destination.w && source.h == destination.h) {
+    int sourceX = source.x + visible.x - destination.x;
+    int sourceY = source.y + visible.y - destination.y;
+    for (int y = 0; y < visible.h; y++) {
+      writeRow(pixelRow(pSource, sourceY + y) + sourceX, pixelRow(pDestination, visible.y + y) + visible.x, visible.w, pBlend);
+    }
+  } else if (ScaleFilter::Nearest == pFilter || source.w < 2) {
+    mRow.resize(visible.w);
+    mColumns.resize(visible.w);
+    for (int x = 0; x < visible.w; x++) {
+      int offset = visible.x + x - destination.x;
+      mColumns[x] = source.x + (int)((2 * (Sint64)offset + 1) * source.w / (2 * (Sint64)destination.w));
+    }
+    for (int y = 0; y < visible.h; y++) {
+      int offset = visible.y + y - destination.y;
+      const Uint32 *row = pixelRow(pSource, source.y + (int)((2 * (Sint64)offset + 1) * source.h / (2 * (Sint64)destination.h)));
+      for (int x = 0; x < visible.w; x++) {
+        mRow[x] = row[mColumns[x]];
+      }
+      writeRow(mRow.data(), pixelRow(pDestination, visible.y + y) + visible.x, visible.w, pBlend);
+    }
+  } else {
+    mRow.resize(visible.w);
+    mColumns.resize(visible.w);
+    mWeights.resize(visible.w);
+    for (int x = 0; x < visible.w; x++) {
+      int position = std::min(std::max(sourceCoordinate(visible.x + x - destination.x, source.w, destination.w), 0), (source.w - 1) * 256);
+      int column = position >> 8;
+      int weight = position & 0xFF;
+      if (source.w - 1 <= column) {
+        // Keep both taps inside the rect: take the last pixel at full weight.
+        column = source.w - 2;
+        weight = 256;
+      }
+      mColumns[x] = source.x + column;
+      mWeights[x] = weight;
+    }
+    for (int y = 0; y < visible.h; y++) {
+      int position = std::min(std::max(sourceCoordinate(visible.y + y - destination.y, source.h, destination.h), 0), (source.h - 1) * 256);
+      int row = position >> 8;
+      int weight = position & 0xFF;
+      const Uint32 *top = pixelRow(pSource, source.y + row);
+      const Uint32 *bottom = row + 1 < source.h ? pixelRow(pSource, source.y + row + 1) : top;
+      mBilinearRow(top, bottom, weight, mColumns.data(), mWeights.data(), mRow.data(), visible.w);
+      writeRow(mRow.data(), pixelRow(pDestination, visible.y + y) + visible.x, visible.w, pBlend);
+    }
+  }
+
+  if (SDL_MUSTLOCK(pDestination)) {
+    SDL_UnlockSurface(pDestination);
+  }
+  if (SDL_MUSTLOCK(pSource)) {
+    SDL_UnlockSurface(pSource);
+  }
+  return true;
+}
+
+bool SoftwareBlitter::fill(SDL_Surface *pDestination, const SDL_Rect *pRect, Uint32 pColor) {
+  if (SDL_PIXELFORMAT_ARGB8888 != pDestination->format->format) {
+    SDL_SetError("SoftwareBlitter needs ARGB8888 surfaces");
+    return false;
+  }
+  SDL_Rect area = pDestination->clip_rect;
+  if (nullptr != pRect && !SDL_IntersectRect(pRect, &pDestination->clip_rect, &area)) {
+    return true;
+  }
+  if (SDL_MUSTLOCK(pDestination)) {
+    SDL_LockSurface(pDestination);
+  }
+  for (int y = 0; y < area.h; y++) {
+    mFillRow(pixelRow(pDestination, area.y + y) + area.x, area.w, pColor);
+  }
+  if (SDL_MUSTLOCK(pDestination)) {
+    SDL_UnlockSurface(pDestination);
+  }
+  return true;
+}
@@ -0,0 +1,119 @@
+#include "SpriteBatch.h"
+
+#include <SDL2/SDL.h>
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+  #error "SpriteBatch requires SDL 2.0.18 or newer for SDL_RenderGeometry"
+#endif
+
+namespace {
+  const size_t RESERVED_SPRITES = 1024;
+  const SDL_Color WHITE = {0xFF, 0xFF, 0xFF, 0xFF};
+}
+
+SpriteBatch *SpriteBatch::sCurrent = nullptr;
+
+SpriteBatch::SpriteBatch(SDL_Renderer *pRenderer) :
+  mRenderer(pRenderer),
+  mTexture(nullptr),
+  mTextureWidth(0),
+  mTextureHeight(0),
+  mDrawCalls(0),
+  mTextureSwitches(0),
+  mSprites(0)
+{
+  mVertices.reserve(4 * RESERVED_SPRITES);
+  mIndices.reserve(6 * RESERVED_SPRITES);
+}
+
+SpriteBatch::~SpriteBatch(void) {
+  if (this == sCurrent) {
+    sCurrent = nullptr;
+  }
+}
+
+void SpriteBatch::begin(void) {
+  sCurrent = this;
+}
+
+void SpriteBatch::end(void) {
+  flush();
+  mTexture = nullptr;
+  if (this == sCurrent) {
+    sCurrent = nullptr;
+  }
+}
+
+SpriteBatch *SpriteBatch::current(SDL_Renderer *pRenderer) {
+  return nullptr != sCurrent && pRenderer == sCurrent->mRenderer ? sCurrent : nullptr;
+}
+
+void SpriteBatch::draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip) {
+  draw(pTexture, pDestination, pClip, WHITE);
+}
+
+void SpriteBatch::draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip, SDL_Color pColor) {
+  if (pTexture != mTexture) {
+    flush();
+    mTexture = pTexture;
+    mTextureSwitches++;
+    SDL_QueryTexture(pTexture, nullptr, nullptr, &mTextureWidth, &mTextureHeight);
+  }
+  if (mTextureWidth <= 0 || mTextureHeight <= 0) {
+    return;
+  }
+  float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+  if (nullptr != pClip) {
+    u0 = (float)pClip->x / mTextureWidth;
+    v0 = (float)pClip->y / mTextureHeight;
+    u1 = (float)(pClip->x + pClip->w) / mTextureWidth;
+    v1 = (float)(pClip->y + pClip->h) / mTextureHeight;
+  }
+  float x0 = pDestination.x;
+  float y0 = pDestination.y;
+  float x1 = pDestination.x + pDestination.w;
+  float y1 = pDestination.y + pDestination.h;
+
+  int base = mVertices.size();
+  SDL_Vertex quad[4] = {
+    {{x0, y0}, pColor, {u0, v0}},
+    {{x1, y0}, pColor, {u1, v0}},
+    {{x1, y1}, pColor, {u1, v1}},
+    {{x0, y1}, pColor, {u0, v1}}
+  };
+  mVertices.insert(mVertices.end(), quad, quad + 4);
+  const int indices[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+  mIndices.insert(mIndices.end(), indices, indices + 6);
+  mSprites++;
+}
+
+void SpriteBatch::flush(void) {
+  if (!mIndices.empty()) {
+    SDL_RenderGeometry(mRenderer, mTexture, mVertices.data(), mVertices.size(), mIndices.data(), mIndices.size());
+    mDrawCalls++;
+  }
+  mVertices.clear();
+  mIndices.clear();
+}
+
+SDL_Renderer *SpriteBatch::renderer(void) const {
+  return mRenderer;
+}
+
+int SpriteBatch::drawCalls(void) const {
+  return mDrawCalls;
+}
+
+int SpriteBatch::textureSwitches(void) const {
+  return mTextureSwitches;
+}
+
+int SpriteBatch::sprites(void) const {
+  return mSprites;
+}
+
+void SpriteBatch::resetStats(void) {
+  mDrawCalls = 0;
+  mTextureSwitches = 0;
+  mSprites = 0;
+}
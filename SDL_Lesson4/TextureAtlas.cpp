@@ -0,0 +1,283 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cctype>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <dirent.h>
+#endif
+
+#include "Utility.h"
+
+namespace {
+  const int MAX_PAGE_SIZE = 2048;
+  const int PADDING = 1;
+
+  bool isImageFile(const std::string &pFileName) {
+    size_t dot = pFileName.rfind('.');
+    if (std::string::npos == dot) {
+      return false;
+    }
+    std::string extension = pFileName.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return "png" == extension || "bmp" == extension || "jpg" == extension || "jpeg" == extension;
+  }
+
+  std::vector<std::string> listImages(const std::string &pDirectory) {
+    std::vector<std::string> result;
+    #ifdef _WIN32
+      WIN32_FIND_DATAA entry;
+      HANDLE find = FindFirstFileA((pDirectory + "*").c_str(), &entry);
+      if (INVALID_HANDLE_VALUE != find) {
+        do {
+          if (0 == (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && isImageFile(entry.cFileName)) {
+            result.push_back(entry.cFileName);
+          }
+        } while (FindNextFileA(find, &entry));
+        FindClose(find);
+      }
+    #else
+      DIR *directory = opendir(pDirectory.c_str());
+      if (nullptr != directory) {
+        while (dirent *entry = readdir(directory)) {
+          if ('.' != entry->d_name[0] && isImageFile(entry->d_name)) {
+            result.push_back(entry->d_name);
+          }
+        }
+        closedir(directory);
+      }
+    #endif
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+}
+
+TextureAtlas::TextureAtlas(void) {
+}
+
+TextureAtlas::~TextureAtlas(void) {
+  clear();
+}
+
+void TextureAtlas::clear(void) {
+  for (SDL_Texture *page : mPages) {
+    Utility::cleanup(page);
+  }
+  mPages.clear();
+  mRegions.clear();
+}
+
+int TextureAtlas::pageCount(void) const {
+  return mPages.size();
+}
+
+AtlasTexture TextureAtlas::get(const std::string &pFileName) const {
+  std::map<std::string, AtlasTexture>::const_iterator it = mRegions.find(pFileName);
+  if (mRegions.end() == it) {
+    AtlasTexture missing = {nullptr, {0, 0, 0, 0}};
+    return missing;
+  }
+  return it->second;
+}
+
+bool TextureAtlas::insert(Skyline &pSkyline, int pWidth, int pHeight, SDL_Point &pPosition) {
+  int bestIndex = -1;
+  int bestY = pSkyline.height;
+  for (size_t i = 0; i < pSkyline.nodes.size(); i++) {
+    int x = pSkyline.nodes[i].x;
+    if (pSkyline.width < x + pWidth) {
+      break;
+    }
+    // Rest the rectangle on the highest node it spans.
+    int y = 0;
+    int remaining = pWidth;
+    for (size_t j = i; 0 < remaining; j++) {
+      y = std::max(y, pSkyline.nodes[j].y);
+      remaining -= pSkyline.nodes[j].width;
+    }
+    if (y + pHeight <= pSkyline.height && y < bestY) {
+      bestIndex = i;
+      bestY = y;
+    }
+  }
+  if (bestIndex < 0) {
+    return false;
+  }
+  pPosition.x = pSkyline.nodes[bestIndex].x;
+  pPosition.y = bestY;
+
+  SkylineNode node = {pPosition.x, bestY + pHeight, pWidth};
+  pSkyline.nodes.insert(pSkyline.nodes.begin() + bestIndex, node);
+  // Trim the nodes now shadowed by the new one.
+  size_t i = bestIndex + 1;
+  while (i < pSkyline.nodes.size()) {
+    SkylineNode &next = pSkyline.nodes[i];
+    int shadow = node.x + node.width - next.x;
+    if (shadow <= 0) {
+      break;
+    }
+    if (next.width <= shadow) {
+      pSkyline.nodes.erase(pSkyline.nodes.begin() + i);
+    } else {
+      next.x += shadow;
+      next.width -= shadow;
+      break;
+    }
+  }
+  // Merge neighbours at the same height.
+  for (i = 0; i + 1 < pSkyline.nodes.size(); ) {
+    if (pSkyline.nodes[i].y == pSkyline.nodes[i + 1].y) {
+      pSkyline.nodes[i].width += pSkyline.nodes[i + 1].width;
+      pSkyline.nodes.erase(pSkyline.nodes.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+  return true;
+}
+
+bool TextureAtlas::build(
+  SDL_Renderer *pRenderer,
+  const std::string &pDirectory,
+  AsyncTextureLoader *pLoader,
+  const ResourcePack *pPack
+) {
+  clear();
+
+  struct Image {
+    std::string name;
+    SDL_Surface *surface;
+    int page;
+    SDL_Point position;
+  };
+  std::vector<Image> images;
+  std::vector<std::future<SDL_Surface *> > decoding;
+  std::vector<std::string> names;
+  if (nullptr != pPack) {
+    for (const std::string &name : pPack->list(pDirectory)) {
+      if (isImageFile(name)) {
+        names.push_back(name);
+      }
+    }
+  }
+  if (names.empty()) {
+    names = listImages(pDirectory);
+  }
+  for (const std::string &name : names) {
+    Image image = {name, nullptr, -1, {0, 0}};
+    images.push_back(image);
+    if (nullptr != pLoader) {
+      decoding.push_back(pLoader->decode(pDirectory + name));
+    }
+  }
+  bool decoded = true;
+  for (size_t i = 0; i < images.size(); i++) {
+    if (nullptr != pLoader) {
+      images[i].surface = decoding[i].get();
+    } else {
+      const std::string fileName = pDirectory + images[i].name;
+      SDL_RWops *packed = nullptr == pPack ? nullptr : pPack->openRW(fileName);
+      SDL_Surface *loaded = nullptr == packed ? IMG_Load(fileName.c_str()) : IMG_Load_RW(packed, 1);
+      if (nullptr != loaded) {
+        images[i].surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+        Utility::cleanup(loaded);
+      }
+    }
+    decoded = decoded && nullptr != images[i].surface;
+  }
+  if (!decoded) {
+    for (Image &image : images) {
+      Utility::cleanup(image.surface);
+    }
+    return false;
+  }
+
+  int pageWidth = MAX_PAGE_SIZE;
+  int pageHeight = MAX_PAGE_SIZE;
+  SDL_RendererInfo info;
+  if (0 == SDL_GetRendererInfo(pRenderer, &info) && 0 < info.max_texture_width && 0 < info.max_texture_height) {
+    pageWidth = std::min(pageWidth, info.max_texture_width);
+    pageHeight = std::min(pageHeight, info.max_texture_height);
+  }
+
+  // Tallest first keeps the skyline flat.
+  std::vector<Image *> order;
+  for (Image &image : images) {
+    order.push_back(&image);
+  }
+  std::sort(order.begin(), order.end(), [](const Image *a, const Image *b) {
+    return a->surface->h != b->surface->h ? a->surface->h > b->surface->h : a->surface->w > b->surface->w;
+  });
+  std::vector<Skyline> skylines;
+  for (Image *image : order) {
+    int width = image->surface->w + PADDING;
+    int height = image->surface->h + PADDING;
+    for (size_t i = 0; i < skylines.size() && image->page < 0; i++) {
+      if (insert(skylines[i], width, height, image->position)) {
+        image->page = i;
+      }
+    }
+    if (image->page < 0) {
+      // Oversized images get a page of their own.
+      Skyline skyline = {std::max(pageWidth, width), std::max(pageHeight, height), {}};
+      SkylineNode root = {0, 0, skyline.width};
+      skyline.nodes.push_back(root);
+      insert(skyline, width, height, image->position);
+      image->page = skylines.size();
+      skylines.push_back(skyline);
+    }
+  }
+
+  bool result = true;
+  for (size_t i = 0; i < skylines.size() && result; i++) {
+    // Trim each page to the area the skyline actually used.
+    int usedWidth = 0;
+    int usedHeight = 0;
+    for (const SkylineNode &node : skylines[i].nodes) {
+      if (0 < node.y) {
+        usedWidth = node.x + node.width;
+      }
+      usedHeight = std::max(usedHeight, node.y);
+    }
+    SDL_Surface *page = SDL_CreateRGBSurfaceWithFormat(0, usedWidth, usedHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (nullptr == page) {
+      result = false;
+      break;
+    }
+    SDL_FillRect(page, nullptr, 0);
+    for (const Image &image : images) {
+      if (image.page == (int)i) {
+        SDL_Rect destination = {image.position.x, image.position.y, image.surface->w, image.surface->h};
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(image.surface, nullptr, page, &destination);
+      }
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(pRenderer, page);
+    Utility::cleanup(page);
+    if (nullptr == texture) {
+      result = false;
+      break;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    mPages.push_back(texture);
+  }
+
+  for (Image &image : images) {
+    if (result) {
+      AtlasTexture handle = {
+        mPages[image.page],
+        {image.position.x, image.position.y, image.surface->w, image.surface->h}
+      };
+      mRegions[image.name] = handle;
+    }
+    Utility::cleanup(image.surface);
+  }
+  if (!result) {
+    clear();
+  }
+  return result;
+}
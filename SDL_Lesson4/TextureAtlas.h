@@ -0,0 +1,63 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "AsyncTextureLoader.h"
+#include "ResourcePack.h"
+
+/*
+ * A region of a shared atlas page.  Handles are cheap to copy; the page
+ * texture is owned by the TextureAtlas that returned the handle.
+ */
+struct AtlasTexture {
+  SDL_Texture *texture;
+  SDL_Rect region;
+};
+
+/*
+ * Packs every image in a resource directory into as few textures as the
+ * renderer allows, using a skyline bottom-left packer.
+ */
+class TextureAtlas {
+  public:
+    TextureAtlas(void);
+    ~TextureAtlas(void);
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    // Returns false and leaves SDL_GetError set if any image fails to load.
+    // With a loader, images are decoded in parallel on its worker threads.
+    // With a pack that holds pDirectory, images are listed and read from it.
+    bool build(
+      SDL_Renderer *pRenderer,
+      const std::string &pDirectory,
+      AsyncTextureLoader *pLoader = nullptr,
+      const ResourcePack *pPack = nullptr
+    );
+    // Returns a handle with a null texture if pFileName was not packed.
+    AtlasTexture get(const std::string &pFileName) const;
+    int pageCount(void) const;
+    void clear(void);
+
+  private:
+    struct SkylineNode {
+      int x;
+      int y;
+      int width;
+    };
+    struct Skyline {
+      int width;
+      int height;
+      std::vector<SkylineNode> nodes;
+    };
+    static bool insert(Skyline &pSkyline, int pWidth, int pHeight, SDL_Point &pPosition);
+
+    std::vector<SDL_Texture *> mPages;
+    std::map<std::string, AtlasTexture> mRegions;
+};
+
+#endif // TEXTURE_ATLAS_H
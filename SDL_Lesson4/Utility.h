@@ -34,6 +34,15 @@ namespace Utility {
       SDL_FreeSurface(surface);
     }
   }
+
+  // Frees through cleanup(), so std::unique_ptr and std::shared_ptr can own
+  // SDL objects.
+  struct Deleter {
+    template<typename T>
+    void operator()(T *t) const {
+      cleanup(t);
+    }
+  };
 }
 
 #endif // UTILITY_H
@@ -0,0 +1,206 @@
+#include "CpuCanvas.h"
+
+#include <SDL2/SDL.h>
+
+#include "SpriteBatch.h"
+#include "Utility.h"
+
+CpuCanvas *CpuCanvas::sCurrent = nullptr;
+
+CpuCanvas::CpuCanvas(SDL_Renderer *pRenderer) :
+  mRenderer(pRenderer),
+  mFramebuffer(nullptr),
+  mTexture(nullptr),
+  mFilter(ScaleFilter::Nearest),
+  mFrame(0),
+  mSuspended(false)
+{
+}
+
+CpuCanvas::~CpuCanvas(void) {
+  clear();
+}
+
+void CpuCanvas::clear(void) {
+  if (this == sCurrent) {
+    sCurrent = nullptr;
+  }
+  for (std::pair<SDL_Texture * const, Snapshot> &entry : mSnapshots) {
+    Utility::cleanup(entry.second.surface);
+  }
+  mSnapshots.clear();
+  mTiles.reset();
+  Utility::cleanup(mTexture);
+  mTexture = nullptr;
+  Utility::cleanup(mFramebuffer);
+  mFramebuffer = nullptr;
+}
+
+bool CpuCanvas::create(int pWidth, int pHeight, ScaleFilter pFilter, int pThreads) {
+  clear();
+  mFramebuffer = SDL_CreateRGBSurfaceWithFormat(0, pWidth, pHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+  if (nullptr == mFramebuffer) {
+    return false;
+  }
+  mTexture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, pWidth, pHeight);
+  if (nullptr == mTexture) {
+    clear();
+    return false;
+  }
+  SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_NONE);
+  mFilter = pFilter;
+  if (1 != pThreads) {
+    mTiles.reset(new TileRasterizer(pThreads));
+  }
+  return true;
+}
+
+bool CpuCanvas::ready(void) const {
+  return nullptr != mFramebuffer;
+}
+
+void CpuCanvas::begin(void) {
+  if (nullptr == mFramebuffer) {
+    return;
+  }
+  Uint8 red, green, blue, alpha;
+  SDL_GetRenderDrawColor(mRenderer, &red, &green, &blue, &alpha);
+  Uint32 color = SDL_MapRGBA(mFramebuffer->format, red, green, blue, alpha);
+  if (mTiles) {
+    mTiles->fill(nullptr, color);
+  } else {
+    mBlitter.fill(mFramebuffer, nullptr, color);
+  }
+  mFrame++;
+  mSuspended = false;
+  sCurrent = this;
+}
+
+void CpuCanvas::end(void) {
+  if (this != sCurrent) {
+    return;
+  }
+  sCurrent = nullptr;
+  if (!mSuspended) {
+    present();
+  }
+  mSuspended = false;
+}
+
+void CpuCanvas::present(void) {
+  if (mTiles) {
+    mTiles->render(mFramebuffer);
+  }
+  SDL_UpdateTexture(mTexture, nullptr, mFramebuffer->pixels, mFramebuffer->pitch);
+  // Draws batched before begin() go under the framebuffer.
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  if (nullptr != batch) {
+    batch->flush();
+  }
+  SDL_RenderCopy(mRenderer, mTexture, nullptr, nullptr);
+}
+
+CpuCanvas *CpuCanvas::current(SDL_Renderer *pRenderer) {
+  return nullptr != sCurrent && pRenderer == sCurrent->mRenderer ? sCurrent : nullptr;
+}
+
+bool CpuCanvas::draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip) {
+  if (mSuspended) {
+    return false;
+  }
+  SDL_BlendMode blendMode;
+  Uint8 red, green, blue, alpha;
+  SDL_GetTextureBlendMode(pTexture, &blendMode);
+  SDL_GetTextureColorMod(pTexture, &red, &green, &blue);
+  SDL_GetTextureAlphaMod(pTexture, &alpha);
+  SDL_Surface *surface = nullptr;
+  if ((SDL_BLENDMODE_NONE == blendMode || SDL_BLENDMODE_BLEND == blendMode)
+    && 0xFF == (red & green & blue & alpha)) {
+    surface = snapshot(pTexture);
+  }
+  if (nullptr != surface) {
+    if (mTiles) {
+      mTiles->draw(surface, pClip, pDestination, mFilter, SDL_BLENDMODE_BLEND == blendMode);
+      return true;
+    }
+    if (mBlitter.blit(surface, pClip, mFramebuffer, &pDestination, mFilter, SDL_BLENDMODE_BLEND == blendMode)) {
+      return true;
+    }
+  }
+  // The renderer draws this copy, so everything drawn before it has to be
+  // there first, and everything after it has to follow it there.
+  present();
+  mSuspended = true;
+  return false;
+}
+
+SDL_Surface *CpuCanvas::snapshot(SDL_Texture *pTexture) {
+  std::map<SDL_Texture *, Snapshot>::iterator it = mSnapshots.find(pTexture);
+  if (mSnapshots.end() != it && (!it->second.streaming || mFrame == it->second.frame)) {
+    return it->second.surface;
+  }
+  // A streaming texture may have been updated since it was last read back.
+  // A failed read-back is remembered too, so the texture stays on the
+  // renderer instead of being retried every frame.
+  Snapshot unused = {nullptr, false, 0};
+  Snapshot &snapshot = mSnapshots.insert(std::make_pair(pTexture, unused)).first->second;
+  if (!readBack(pTexture, snapshot)) {
+    Utility::cleanup(snapshot.surface);
+    snapshot.surface = nullptr;
+    snapshot.streaming = false;
+  }
+  snapshot.frame = mFrame;
+  return snapshot.surface;
+}
+
+bool CpuCanvas::readBack(SDL_Texture *pTexture, Snapshot &pSnapshot) {
+  int access, width, height;
+  if (0 != SDL_QueryTexture(pTexture, nullptr, &access, &width, &height)) {
+    return false;
+  }
+  pSnapshot.streaming = SDL_TEXTUREACCESS_STREAMING == access;
+  if (nullptr != pSnapshot.surface && (width != pSnapshot.surface->w || height != pSnapshot.surface->h)) {
+    Utility::cleanup(pSnapshot.surface);
+    pSnapshot.surface = nullptr;
+  }
+  if (nullptr == pSnapshot.surface) {
+    pSnapshot.surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (nullptr == pSnapshot.surface) {
+      return false;
+    }
+  }
+  SDL_Texture *target = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+  if (nullptr == target) {
+    return false;
+  }
+
+  // Copy the texture unblended into a target, so its alpha survives, and
+  // read the target back.
+  SDL_BlendMode blendMode;
+  SDL_GetTextureBlendMode(pTexture, &blendMode);
+  SDL_Texture *previousTarget = SDL_GetRenderTarget(mRenderer);
+  SDL_SetRenderTarget(mRenderer, target);
+  SDL_SetTextureBlendMode(pTexture, SDL_BLENDMODE_NONE);
+  SDL_RenderCopy(mRenderer, pTexture, nullptr, nullptr);
+  SDL_SetTextureBlendMode(pTexture, blendMode);
+  int result = SDL_RenderReadPixels(mRenderer, nullptr, SDL_PIXELFORMAT_ARGB8888, pSnapshot.surface->pixels, pSnapshot.surface->pitch);
+  SDL_SetRenderTarget(mRenderer, previousTarget);
+  Utility::cleanup(target);
+  return 0 == result;
+}
+
+void CpuCanvas::forget(SDL_Texture *pTexture) {
+  std::map<SDL_Texture *, Snapshot>::iterator it = mSnapshots.find(pTexture);
+  if (mSnapshots.end() != it) {
+    Utility::cleanup(it->second.surface);
+    mSnapshots.erase(it);
+  }
+}
+
+SoftwareBlitter &CpuCanvas::blitter(void) {
+  return mBlitter;
+}
+
+int CpuCanvas::threads(void) const {
+  return mTiles ? mTiles->threads() : 1;
+}
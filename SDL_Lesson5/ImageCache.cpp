@@ -0,0 +1,156 @@
+#include "ImageCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#ifdef _WIN32
+  #include <direct.h>
+#endif
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "Utility.h"
+
+namespace {
+  const char CACHE_MAGIC[8] = {'S', 'D', 'L', 'I', 'M', 'G', '0', '1'};
+
+  bool readAll(SDL_RWops *pFile, void *pData, size_t pSize) {
+    return 0 == pSize || 1 == SDL_RWread(pFile, pData, pSize, 1);
+  }
+}
+
+ImageCache::ImageCache(const std::string &pDirectory, Uint32 pFormat) :
+  mDirectory(pDirectory),
+  mFormat(pFormat),
+  mHits(0),
+  mMisses(0)
+{
+  if (!mDirectory.empty()) {
+    #ifdef _WIN32
+      _mkdir(mDirectory.c_str());
+    #else
+      mkdir(mDirectory.c_str(), 0755);
+    #endif
+  }
+}
+
+unsigned long ImageCache::hits(void) const {
+  return mHits;
+}
+
+unsigned long ImageCache::misses(void) const {
+  return mMisses;
+}
+
+std::string ImageCache::entryPath(const std::string &pFileName) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.raw", (unsigned long long)packHash(pFileName));
+  return mDirectory + name;
+}
+
+SDL_Surface *ImageCache::read(const std::string &pPath, Uint64 pStamp, Uint64 pSize) const {
+  SDL_RWops *file = SDL_RWFromFile(pPath.c_str(), "rb");
+  if (nullptr == file) {
+    return nullptr;
+  }
+  Header header;
+  SDL_Surface *result = nullptr;
+  if (readAll(file, &header, sizeof(header))
+    && 0 == memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC))
+    && mFormat == header.format
+    && pStamp == header.sourceStamp
+    && pSize == header.sourceSize
+  ) {
+    result = SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, SDL_BITSPERPIXEL(mFormat), mFormat);
+  }
+  if (nullptr != result) {
+    // Read row by row in case the surface pitch differs from the stored one.
+    int rowBytes = header.width * SDL_BYTESPERPIXEL(mFormat);
+    bool complete = header.pitch == result->pitch
+      ? readAll(file, result->pixels, (size_t)result->pitch * header.height)
+      : rowBytes <= header.pitch;
+    for (int y = 0; complete && header.pitch != result->pitch && y < header.height; y++) {
+      complete = readAll(file, static_cast<Uint8 *>(result->pixels) + y * result->pitch, rowBytes)
+        && 0 <= SDL_RWseek(file, header.pitch - rowBytes, RW_SEEK_CUR);
+    }
+    if (!complete) {
+      Utility::cleanup(result);
+      result = nullptr;
+    }
+  }
+  SDL_RWclose(file);
+  return result;
+}
+
+void ImageCache::write(const std::string &pPath, const SDL_Surface *pSurface, Uint64 pStamp, Uint64 pSize) const {
+  Header header;
+  memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.format = mFormat;
+  header.width = pSurface->w;
+  header.height = pSurface->h;
+  header.pitch = pSurface->pitch;
+  header.sourceStamp = pStamp;
+  header.sourceSize = pSize;
+  // Write beside the entry and rename, so concurrent runs never read a
+  // half-written blob.
+  const std::string temporary = pPath + ".tmp";
+  SDL_RWops *file = SDL_RWFromFile(temporary.c_str(), "wb");
+  if (nullptr == file) {
+    return;
+  }
+  size_t bytes = (size_t)pSurface->pitch * pSurface->h;
+  bool complete = 1 == SDL_RWwrite(file, &header, sizeof(header), 1)
+    && (0 == bytes || 1 == SDL_RWwrite(file, pSurface->pixels, bytes, 1));
+  complete = 0 == SDL_RWclose(file) && complete;
+  if (complete) {
+    remove(pPath.c_str());
+    complete = 0 == rename(temporary.c_str(), pPath.c_str());
+  }
+  if (!complete) {
+    remove(temporary.c_str());
+  }
+}
+
+SDL_Surface *ImageCache::decode(const std::string &pFileName, const ResourcePack *pPack) {
+  size_t packedSize = 0;
+  const void *packed = nullptr == pPack ? nullptr : pPack->find(pFileName, &packedSize);
+  Uint64 stamp = 0;
+  Uint64 size = 0;
+  bool cacheable = !mDirectory.empty();
+  if (nullptr != packed) {
+    stamp = packHash(packed, packedSize);
+    size = packedSize;
+  } else {
+    struct stat status;
+    cacheable = cacheable && 0 == stat(pFileName.c_str(), &status);
+    if (cacheable) {
+      stamp = status.st_mtime;
+      size = status.st_size;
+    }
+  }
+
+  const std::string path = entryPath(pFileName);
+  if (cacheable) {
+    SDL_Surface *cached = read(path, stamp, size);
+    if (nullptr != cached) {
+      mHits++;
+      return cached;
+    }
+  }
+  mMisses++;
+
+  SDL_Surface *loaded = nullptr == packed
+    ? IMG_Load(pFileName.c_str())
+    : IMG_Load_RW(SDL_RWFromConstMem(packed, packedSize), 1);
+  if (nullptr == loaded) {
+    return nullptr;
+  }
+  SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, mFormat, 0);
+  Utility::cleanup(loaded);
+  if (nullptr != converted && cacheable) {
+    write(path, converted, stamp, size);
+  }
+  return converted;
+}
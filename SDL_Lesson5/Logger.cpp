@@ -0,0 +1,213 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <SDL2/SDL.h>
+
+namespace {
+  const int MIN_CAPACITY = 16;
+  // How long the writer sleeps when the ring is empty.
+  const std::chrono::milliseconds DRAIN_INTERVAL(10);
+}
+
+Logger::Logger(std::ostream &pOutputStream, int pCapacity, int pMessagesPerSecond) :
+  mOutputStream(pOutputStream),
+  mMask(0),
+  mEnqueue(0),
+  mDequeue(0),
+  mLevel((int)LogLevel::Info),
+  mMessagesPerSecond(pMessagesPerSecond),
+  mFrequency(SDL_GetPerformanceFrequency()),
+  mWindow(0),
+  mWindowCount(0),
+  mDropped(0),
+  mRateLimited(0),
+  mReportedDropped(0),
+  mReportedRateLimited(0),
+  mStopping(false)
+{
+  size_t capacity = MIN_CAPACITY;
+  while (capacity < (size_t)pCapacity) {
+    capacity *= 2;
+  }
+  mRecords.reset(new Record[capacity]);
+  mMask = capacity - 1;
+  for (size_t i = 0; i < capacity; i++) {
+    mRecords[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  mThread = std::thread(&Logger::work, this);
+}
+
+Logger::~Logger(void) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWake.notify_all();
+  mThread.join();
+}
+
+Logger &Logger::console(void) {
+  static Logger logger(std::cout);
+  return logger;
+}
+
+void Logger::setLevel(LogLevel pLevel) {
+  mLevel.store((int)pLevel, std::memory_order_relaxed);
+}
+
+LogLevel Logger::level(void) const {
+  return (LogLevel)mLevel.load(std::memory_order_relaxed);
+}
+
+unsigned long Logger::dropped(void) const {
+  return mDropped.load(std::memory_order_relaxed);
+}
+
+unsigned long Logger::rateLimited(void) const {
+  return mRateLimited.load(std::memory_order_relaxed);
+}
+
+bool Logger::admit(LogLevel pLevel) {
+  if (LogLevel::Error == pLevel) {
+    return true;
+  }
+  // Keep the last quarter of the ring for errors.
+  size_t used = mEnqueue.load(std::memory_order_relaxed) - mDequeue.load(std::memory_order_relaxed);
+  if ((mMask + 1) / 4 * 3 <= used) {
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  if (mMessagesPerSecond <= 0) {
+    return true;
+  }
+  Uint64 window = SDL_GetPerformanceCounter() / mFrequency;
+  Uint64 current = mWindow.load(std::memory_order_relaxed);
+  if (window != current && mWindow.compare_exchange_strong(current, window, std::memory_order_relaxed)) {
+    mWindowCount.store(0, std::memory_order_relaxed);
+  }
+  if (mMessagesPerSecond <= mWindowCount.fetch_add(1, std::memory_order_relaxed)) {
+    mRateLimited.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+Logger::Record *Logger::acquire(LogLevel pLevel, size_t &pPosition) {
+  if ((int)pLevel < mLevel.load(std::memory_order_relaxed) || !admit(pLevel)) {
+    return nullptr;
+  }
+  // Bounded multi-producer queue: a record is free for position p when its
+  // sequence equals p, and published when it equals p + 1.
+  size_t position = mEnqueue.load(std::memory_order_relaxed);
+  for (;;) {
+    Record &record = mRecords[position & mMask];
+    size_t sequence = record.sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (mEnqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        pPosition = position;
+        return &record;
+      }
+    } else if (sequence < position) {
+      // Full: the writer has not released this record yet.
+      mDropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    } else {
+      position = mEnqueue.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void Logger::publish(Record *pRecord, size_t pPosition) {
+  pRecord->sequence.store(pPosition + 1, std::memory_order_release);
+}
+
+bool Logger::log(LogLevel pLevel, const char *pFormat, ...) {
+  va_list arguments;
+  va_start(arguments, pFormat);
+  bool logged = logv(pLevel, pFormat, arguments);
+  va_end(arguments);
+  return logged;
+}
+
+bool Logger::logv(LogLevel pLevel, const char *pFormat, va_list pArguments) {
+  size_t position;
+  Record *record = acquire(pLevel, position);
+  if (nullptr == record) {
+    return false;
+  }
+  vsnprintf(record->text, MESSAGE_SIZE, pFormat, pArguments);
+  publish(record, position);
+  return true;
+}
+
+void Logger::write(LogLevel pLevel, const std::string &pText) {
+  size_t start = 0;
+  while (start < pText.size()) {
+    size_t end = pText.find('\n', start);
+    if (std::string::npos == end) {
+      end = pText.size();
+    }
+    size_t position;
+    Record *record = acquire(pLevel, position);
+    if (nullptr != record) {
+      size_t length = std::min(end - start, (size_t)MESSAGE_SIZE - 1);
+      memcpy(record->text, pText.data() + start, length);
+      record->text[length] = '\0';
+      publish(record, position);
+    }
+    start = end + 1;
+  }
+}
+
+size_t Logger::drain(void) {
+  size_t count = 0;
+  for (;;) {
+    size_t position = mDequeue.load(std::memory_order_relaxed);
+    Record &record = mRecords[position & mMask];
+    if (record.sequence.load(std::memory_order_acquire) != position + 1) {
+      return count;
+    }
+    mOutputStream << record.text << '\n';
+    record.sequence.store(position + mMask + 1, std::memory_order_release);
+    mDequeue.store(position + 1, std::memory_order_release);
+    count++;
+  }
+}
+
+void Logger::flush(void) {
+  size_t target = mEnqueue.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mMutex);
+  mWake.notify_one();
+  mFlushed.wait(lock, [this, target] { return target <= mDequeue.load(std::memory_order_acquire) || mStopping; });
+}
+
+void Logger::work(void) {
+  for (;;) {
+    size_t written = drain();
+    unsigned long dropped = mDropped.load(std::memory_order_relaxed);
+    unsigned long rateLimited = mRateLimited.load(std::memory_order_relaxed);
+    if (dropped != mReportedDropped || rateLimited != mReportedRateLimited) {
+      mOutputStream << "Logger: dropped " << dropped - mReportedDropped
+        << " message(s), rate limited " << rateLimited - mReportedRateLimited << '\n';
+      mReportedDropped = dropped;
+      mReportedRateLimited = rateLimited;
+      written++;
+    }
+    if (0 < written) {
+      mOutputStream.flush();
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFlushed.notify_all();
+    if (mStopping) {
+      if (mDequeue.load(std::memory_order_relaxed) == mEnqueue.load(std::memory_order_relaxed)) {
+        return;
+      }
+      continue;
+    }
+    mWake.wait_for(lock, DRAIN_INTERVAL);
+  }
+}
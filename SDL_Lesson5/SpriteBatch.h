@@ -0,0 +1,49 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * Accumulates textured quads and submits each run of quads that share a
+ * texture with a single SDL_RenderGeometry call.  Between begin() and end()
+ * the batch is current for its renderer, so renderTexture routes through it.
+ */
+class SpriteBatch {
+  public:
+    explicit SpriteBatch(SDL_Renderer *pRenderer);
+    ~SpriteBatch(void);
+    SpriteBatch(const SpriteBatch &) = delete;
+    SpriteBatch &operator=(const SpriteBatch &) = delete;
+
+    void begin(void);
+    void end(void);
+    void draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip = nullptr);
+    void draw(SDL_Texture *pTexture, const SDL_Rect &pDestination, const SDL_Rect *pClip, SDL_Color pColor);
+    void flush(void);
+
+    SDL_Renderer *renderer(void) const;
+    int drawCalls(void) const;
+    // Times a draw bound a different texture from the one before it.
+    int textureSwitches(void) const;
+    int sprites(void) const;
+    void resetStats(void);
+
+    // The batch between begin() and end() for pRenderer, or nullptr.
+    static SpriteBatch *current(SDL_Renderer *pRenderer);
+
+  private:
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mTexture;
+    int mTextureWidth;
+    int mTextureHeight;
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    int mDrawCalls;
+    int mTextureSwitches;
+    int mSprites;
+
+    static SpriteBatch *sCurrent;
+};
+
+#endif // SPRITE_BATCH_H
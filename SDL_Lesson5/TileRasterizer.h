@@ -0,0 +1,88 @@
+#ifndef TILE_RASTERIZER_H
+#define TILE_RASTERIZER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#include "SoftwareBlitter.h"
+
+/*
+ * Deferred, multi-threaded rasterisation for SoftwareBlitter.  Draws are
+ * recorded for the frame; render() bins them into square screen tiles and a
+ * pool of threads (the caller's included) rasterises whole tiles in
+ * parallel, each tile replaying its draws in recorded order.  The output is
+ * bit-identical to issuing the same draws directly on one SoftwareBlitter.
+ * Source surfaces must stay alive and unchanged until render() returns.
+ */
+class TileRasterizer {
+  public:
+    // pThreads <= 0 uses one thread per CPU.
+    explicit TileRasterizer(int pThreads = 0, int pTileSize = 64);
+    ~TileRasterizer(void);
+    TileRasterizer(const TileRasterizer &) = delete;
+    TileRasterizer &operator=(const TileRasterizer &) = delete;
+
+    void draw(
+      SDL_Surface *pSource,
+      const SDL_Rect *pSourceRect,
+      const SDL_Rect &pDestination,
+      ScaleFilter pFilter = ScaleFilter::Nearest,
+      bool pBlend = true
+    );
+    // Fills pRect, or the whole target for nullptr.
+    void fill(const SDL_Rect *pRect, Uint32 pColor);
+    // Rasterises the recorded draws into pTarget, an ARGB8888 surface, and
+    // starts a new draw list.  Returns false and sets SDL_GetError if a tile
+    // view cannot be created.
+    bool render(SDL_Surface *pTarget);
+
+    int threads(void) const;
+    // Applies to every thread's blitter; false if pLevel is unavailable.
+    bool setLevel(BlitLevel pLevel);
+    BlitLevel level(void) const;
+
+  private:
+    // A fill when source is nullptr.
+    struct Command {
+      SDL_Surface *source;
+      SDL_Rect sourceRect;
+      SDL_Rect destination;
+      ScaleFilter filter;
+      bool blend;
+      Uint32 color;
+    };
+    struct Tile {
+      SDL_Rect bounds;
+      SDL_Surface *view;
+      std::vector<int> commands;
+    };
+
+    bool prepareTiles(SDL_Surface *pTarget);
+    void freeTiles(void);
+    void rasterize(SoftwareBlitter &pBlitter);
+    void work(int pIndex);
+
+    int mTileSize;
+    std::vector<Command> mCommands;
+    std::vector<Tile> mTiles;
+    void *mPixels;
+    int mWidth;
+    int mHeight;
+    int mColumns;
+    // One blitter per thread; index 0 belongs to the calling thread.
+    std::vector<SoftwareBlitter> mBlitters;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    unsigned long mGeneration;
+    int mBusy;
+    bool mStopping;
+    std::atomic<size_t> mNextTile;
+};
+
+#endif // TILE_RASTERIZER_H
@@ -0,0 +1,254 @@
+#include "Animator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  const float PI = 3.14159265f;
+  const float TWO_PI = 6.28318531f;
+  const float INV_TWO_PI = 0.159154943f;
+  const float MIN_DURATION = 1e-6f;
+
+  // Parabolic sine with one refinement step; absolute error below 0.001,
+  // which is invisible at pixel scale.  Branch-free so loops over it
+  // vectorise.
+  inline float fastSin(float pRadians) {
+    const float B = 4.0f / PI;
+    const float C = -4.0f / (PI * PI);
+    const float P = 0.225f;
+    float turns = (float)(int)(pRadians * INV_TWO_PI + (0.0f <= pRadians ? 0.5f : -0.5f));
+    float x = pRadians - turns * TWO_PI;
+    float y = B * x + C * x * std::fabs(x);
+    return P * (y * std::fabs(y) - y) + y;
+  }
+
+  float ease(Easing pEasing, float pProgress) {
+    float u = pProgress;
+    switch (pEasing) {
+      case Easing::InQuad:
+        return u * u;
+      case Easing::OutQuad:
+        return u * (2.0f - u);
+      case Easing::InOutQuad:
+        return u < 0.5f ? 2.0f * u * u : -1.0f + (4.0f - 2.0f * u) * u;
+      case Easing::InOutCubic:
+        return u < 0.5f ? 4.0f * u * u * u : 1.0f + 4.0f * (u - 1.0f) * (u - 1.0f) * (u - 1.0f);
+      case Easing::Linear:
+      default:
+        return u;
+    }
+  }
+
+  template<typename T>
+  void swapRemove(std::vector<T> &pVector, size_t pIndex) {
+    pVector[pIndex] = pVector.back();
+    pVector.pop_back();
+  }
+}
+
+Animator::Animator(void) {
+}
+
+Animator::Track Animator::allocate(Kind pKind, size_t pIndex) {
+  Location location = {pKind, pIndex, true};
+  if (!mFree.empty()) {
+    Track track = mFree.back();
+    mFree.pop_back();
+    mLocations[track] = location;
+    return track;
+  }
+  mLocations.push_back(location);
+  return mLocations.size() - 1;
+}
+
+void Animator::moved(Track pTrack, size_t pIndex) {
+  mLocations[pTrack].index = pIndex;
+}
+
+Animator::Track Animator::sine(float *pTarget, float pOffset, float pAmplitude, float pRadiansPerSecond, float pPhase) {
+  Track track = allocate(SINE, mSines.targets.size());
+  mSines.targets.push_back(pTarget);
+  mSines.offsets.push_back(pOffset);
+  mSines.amplitudes.push_back(pAmplitude);
+  mSines.frequencies.push_back(pRadiansPerSecond);
+  mSines.phases.push_back(pPhase);
+  mSines.values.push_back(pOffset);
+  mSines.handles.push_back(track);
+  return track;
+}
+
+Animator::Track Animator::cosine(float *pTarget, float pOffset, float pAmplitude, float pRadiansPerSecond, float pPhase) {
+  return sine(pTarget, pOffset, pAmplitude, pRadiansPerSecond, pPhase + PI / 2.0f);
+}
+
+Animator::Track Animator::tween(
+  float *pTarget,
+  float pFrom,
+  float pTo,
+  float pStart,
+  float pDuration,
+  Easing pEasing,
+  bool pLoop
+) {
+  Track track = allocate(TWEEN, mTweens.targets.size());
+  mTweens.targets.push_back(pTarget);
+  mTweens.from.push_back(pFrom);
+  mTweens.to.push_back(pTo);
+  mTweens.starts.push_back(pStart);
+  mTweens.durations.push_back(std::max(pDuration, MIN_DURATION));
+  mTweens.easings.push_back(pEasing);
+  mTweens.loops.push_back(pLoop ? 1 : 0);
+  mTweens.values.push_back(pFrom);
+  mTweens.handles.push_back(track);
+  return track;
+}
+
+Animator::Track Animator::linear(float *pTarget, float pFrom, float pTo, float pStart, float pDuration, bool pLoop) {
+  return tween(pTarget, pFrom, pTo, pStart, pDuration, Easing::Linear, pLoop);
+}
+
+Animator::Track Animator::keyframes(float *pTarget, const std::vector<std::pair<float, float> > &pKeys, bool pLoop) {
+  Track track = allocate(KEYFRAMES, mKeyframes.targets.size());
+  mKeyframes.targets.push_back(pTarget);
+  mKeyframes.firsts.push_back(mKeyframes.keyTimes.size());
+  mKeyframes.counts.push_back(pKeys.size());
+  mKeyframes.loops.push_back(pLoop ? 1 : 0);
+  mKeyframes.handles.push_back(track);
+  for (const std::pair<float, float> &key : pKeys) {
+    mKeyframes.keyTimes.push_back(key.first);
+    mKeyframes.keyValues.push_back(key.second);
+  }
+  return track;
+}
+
+void Animator::remove(Track pTrack) {
+  if (mLocations.size() <= pTrack || !mLocations[pTrack].live) {
+    return;
+  }
+  Location location = mLocations[pTrack];
+  size_t index = location.index;
+  switch (location.kind) {
+    case SINE:
+      moved(mSines.handles.back(), index);
+      swapRemove(mSines.targets, index);
+      swapRemove(mSines.offsets, index);
+      swapRemove(mSines.amplitudes, index);
+      swapRemove(mSines.frequencies, index);
+      swapRemove(mSines.phases, index);
+      swapRemove(mSines.values, index);
+      swapRemove(mSines.handles, index);
+      break;
+    case TWEEN:
+      moved(mTweens.handles.back(), index);
+      swapRemove(mTweens.targets, index);
+      swapRemove(mTweens.from, index);
+      swapRemove(mTweens.to, index);
+      swapRemove(mTweens.starts, index);
+      swapRemove(mTweens.durations, index);
+      swapRemove(mTweens.easings, index);
+      swapRemove(mTweens.loops, index);
+      swapRemove(mTweens.values, index);
+      swapRemove(mTweens.handles, index);
+      break;
+    case KEYFRAMES: {
+      size_t first = mKeyframes.firsts[index];
+      size_t count = mKeyframes.counts[index];
+      mKeyframes.keyTimes.erase(mKeyframes.keyTimes.begin() + first, mKeyframes.keyTimes.begin() + first + count);
+      mKeyframes.keyValues.erase(mKeyframes.keyValues.begin() + first, mKeyframes.keyValues.begin() + first + count);
+      for (size_t &other : mKeyframes.firsts) {
+        if (first < other) {
+          other -= count;
+        }
+      }
+      moved(mKeyframes.handles.back(), index);
+      swapRemove(mKeyframes.targets, index);
+      swapRemove(mKeyframes.firsts, index);
+      swapRemove(mKeyframes.counts, index);
+      swapRemove(mKeyframes.loops, index);
+      swapRemove(mKeyframes.handles, index);
+      break;
+    }
+  }
+  mLocations[pTrack].live = false;
+  mFree.push_back(pTrack);
+}
+
+void Animator::clear(void) {
+  mSines = SineTracks();
+  mTweens = TweenTracks();
+  mKeyframes = KeyframeTracks();
+  mLocations.clear();
+  mFree.clear();
+}
+
+void Animator::update(double pSeconds) {
+  const float t = (float)pSeconds;
+
+  size_t count = mSines.targets.size();
+  const float *offsets = mSines.offsets.data();
+  const float *amplitudes = mSines.amplitudes.data();
+  const float *frequencies = mSines.frequencies.data();
+  const float *phases = mSines.phases.data();
+  float *values = mSines.values.data();
+  for (size_t i = 0; i < count; i++) {
+    values[i] = offsets[i] + amplitudes[i] * fastSin(frequencies[i] * t + phases[i]);
+  }
+  for (size_t i = 0; i < count; i++) {
+    *mSines.targets[i] = values[i];
+  }
+
+  count = mTweens.targets.size();
+  const float *starts = mTweens.starts.data();
+  const float *durations = mTweens.durations.data();
+  const Uint8 *loops = mTweens.loops.data();
+  values = mTweens.values.data();
+  for (size_t i = 0; i < count; i++) {
+    float progress = std::max((t - starts[i]) / durations[i], 0.0f);
+    float wrapped = progress - (float)(int)progress;
+    values[i] = loops[i] ? wrapped : std::min(progress, 1.0f);
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (Easing::Linear != mTweens.easings[i]) {
+      values[i] = ease(mTweens.easings[i], values[i]);
+    }
+  }
+  const float *from = mTweens.from.data();
+  const float *to = mTweens.to.data();
+  for (size_t i = 0; i < count; i++) {
+    values[i] = from[i] + (to[i] - from[i]) * values[i];
+  }
+  for (size_t i = 0; i < count; i++) {
+    *mTweens.targets[i] = values[i];
+  }
+
+  // Keyframe tracks need a search per track, so they are evaluated one by one.
+  for (size_t i = 0; i < mKeyframes.targets.size(); i++) {
+    size_t keys = mKeyframes.counts[i];
+    if (0 == keys) {
+      continue;
+    }
+    const float *times = mKeyframes.keyTimes.data() + mKeyframes.firsts[i];
+    const float *keyValues = mKeyframes.keyValues.data() + mKeyframes.firsts[i];
+    float local = t;
+    float span = times[keys - 1] - times[0];
+    if (mKeyframes.loops[i] && 0.0f < span) {
+      local = times[0] + std::fmod(local - times[0], span);
+      if (local < times[0]) {
+        local += span;
+      }
+    }
+    if (local <= times[0]) {
+      *mKeyframes.targets[i] = keyValues[0];
+    } else if (times[keys - 1] <= local) {
+      *mKeyframes.targets[i] = keyValues[keys - 1];
+    } else {
+      size_t next = std::upper_bound(times, times + keys, local) - times;
+      float blend = (local - times[next - 1]) / (times[next] - times[next - 1]);
+      *mKeyframes.targets[i] = keyValues[next - 1] + (keyValues[next] - keyValues[next - 1]) * blend;
+    }
+  }
+}
+
+size_t Animator::size(void) const {
+  return mSines.targets.size() + mTweens.targets.size() + mKeyframes.targets.size();
+}
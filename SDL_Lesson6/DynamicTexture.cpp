@@ -0,0 +1,153 @@
+#include "DynamicTexture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <SDL2/SDL.h>
+
+#include "SpriteBatch.h"
+#include "Utility.h"
+
+DynamicTexture::DynamicTexture(SDL_Renderer *pRenderer) :
+  mRenderer(pRenderer),
+  mTexture(nullptr),
+  mCapacityWidth(0),
+  mCapacityHeight(0),
+  mWidth(0),
+  mHeight(0),
+  mStats()
+{
+}
+
+DynamicTexture::~DynamicTexture(void) {
+  clear();
+}
+
+void DynamicTexture::clear(void) {
+  Utility::cleanup(mTexture);
+  mTexture = nullptr;
+  mCapacityWidth = 0;
+  mCapacityHeight = 0;
+  mWidth = 0;
+  mHeight = 0;
+  mShadow.clear();
+}
+
+bool DynamicTexture::reserve(int pWidth, int pHeight) {
+  if (pWidth <= mCapacityWidth && pHeight <= mCapacityHeight) {
+    return true;
+  }
+  int width = pWidth <= mCapacityWidth ? mCapacityWidth : std::max(pWidth, 2 * mCapacityWidth);
+  int height = pHeight <= mCapacityHeight ? mCapacityHeight : std::max(pHeight, 2 * mCapacityHeight);
+  SDL_Texture *texture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+  if (nullptr == texture) {
+    return false;
+  }
+  // Start transparent, so the shadow matches every texel.
+  void *pixels;
+  int pitch;
+  if (0 != SDL_LockTexture(texture, nullptr, &pixels, &pitch)) {
+    Utility::cleanup(texture);
+    return false;
+  }
+  for (int y = 0; y < height; y++) {
+    memset(static_cast<Uint8 *>(pixels) + y * pitch, 0, width * sizeof(Uint32));
+  }
+  SDL_UnlockTexture(texture);
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+  // Queued quads may still reference the texture being replaced.
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  if (nullptr != batch) {
+    batch->flush();
+  }
+  Utility::cleanup(mTexture);
+  mTexture = texture;
+  mCapacityWidth = width;
+  mCapacityHeight = height;
+  mShadow.assign((size_t)width * height, 0);
+  mStats.creations++;
+  return true;
+}
+
+bool DynamicTexture::update(const SDL_Surface *pSurface, int pWidth, int pHeight) {
+  if (SDL_PIXELFORMAT_ARGB8888 != pSurface->format->format) {
+    SDL_SetError("DynamicTexture: expected an ARGB8888 surface");
+    return false;
+  }
+  if (pWidth <= 0 || pHeight <= 0 || pSurface->w < pWidth || pSurface->h < pHeight) {
+    SDL_SetError("DynamicTexture: invalid region %dx%d", pWidth, pHeight);
+    return false;
+  }
+  if (!reserve(pWidth, pHeight)) {
+    return false;
+  }
+  mStats.updates++;
+  mWidth = pWidth;
+  mHeight = pHeight;
+
+  // Bound the texels that differ from the shadow.
+  int left = mWidth;
+  int right = 0;
+  int top = mHeight;
+  int bottom = 0;
+  for (int y = 0; y < mHeight; y++) {
+    const Uint32 *source = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(pSurface->pixels) + y * pSurface->pitch);
+    const Uint32 *shadow = &mShadow[(size_t)y * mCapacityWidth];
+    int first = 0;
+    while (first < mWidth && source[first] == shadow[first]) {
+      first++;
+    }
+    if (mWidth == first) {
+      continue;
+    }
+    int last = mWidth - 1;
+    while (source[last] == shadow[last]) {
+      last--;
+    }
+    left = std::min(left, first);
+    right = std::max(right, last + 1);
+    top = std::min(top, y);
+    bottom = y + 1;
+  }
+  if (bottom <= top) {
+    return true;
+  }
+
+  SDL_Rect dirty = {left, top, right - left, bottom - top};
+  // Queued quads must draw the contents they were queued with.
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  if (nullptr != batch) {
+    batch->flush();
+  }
+  void *pixels;
+  int pitch;
+  if (0 != SDL_LockTexture(mTexture, &dirty, &pixels, &pitch)) {
+    return false;
+  }
+  for (int y = 0; y < dirty.h; y++) {
+    const Uint32 *source = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(pSurface->pixels) + (dirty.y + y) * pSurface->pitch) + dirty.x;
+    memcpy(static_cast<Uint8 *>(pixels) + y * pitch, source, dirty.w * sizeof(Uint32));
+    memcpy(&mShadow[(size_t)(dirty.y + y) * mCapacityWidth + dirty.x], source, dirty.w * sizeof(Uint32));
+  }
+  SDL_UnlockTexture(mTexture);
+  mStats.uploads++;
+  mStats.uploadedPixels += (unsigned long)dirty.w * dirty.h;
+  return true;
+}
+
+SDL_Texture *DynamicTexture::texture(void) const {
+  return mTexture;
+}
+
+SDL_Rect DynamicTexture::region(void) const {
+  SDL_Rect region = {0, 0, mWidth, mHeight};
+  return region;
+}
+
+size_t DynamicTexture::textureBytes(void) const {
+  return (size_t)mCapacityWidth * mCapacityHeight * sizeof(Uint32);
+}
+
+const DynamicTexture::Stats &DynamicTexture::stats(void) const {
+  return mStats;
+}
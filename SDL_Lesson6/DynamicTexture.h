@@ -0,0 +1,55 @@
+#ifndef DYNAMIC_TEXTURE_H
+#define DYNAMIC_TEXTURE_H
+
+#include <cstddef>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * A persistent streaming texture for content that changes every frame,
+ * such as a frame counter.  update() copies the top-left region of an
+ * ARGB8888 surface, such as a pooled one larger than its content, into the
+ * top-left corner, locking only the rectangle that differs from what the
+ * texture already holds; a CPU shadow of the texture is kept for the
+ * comparison.  The texture is recreated, doubling in each dimension that
+ * is too small, only when the content outgrows it.
+ */
+class DynamicTexture {
+  public:
+    struct Stats {
+      unsigned long updates;
+      // Updates that changed some pixels.
+      unsigned long uploads;
+      unsigned long uploadedPixels;
+      unsigned long creations;
+    };
+
+    explicit DynamicTexture(SDL_Renderer *pRenderer);
+    ~DynamicTexture(void);
+    DynamicTexture(const DynamicTexture &) = delete;
+    DynamicTexture &operator=(const DynamicTexture &) = delete;
+
+    // Copies the top-left pWidth by pHeight pixels of pSurface.  Returns
+    // false and leaves SDL_GetError set on failure.
+    bool update(const SDL_Surface *pSurface, int pWidth, int pHeight);
+    SDL_Texture *texture(void) const;
+    // The part of texture() holding the last update.
+    SDL_Rect region(void) const;
+    size_t textureBytes(void) const;
+    const Stats &stats(void) const;
+    void clear(void);
+
+  private:
+    bool reserve(int pWidth, int pHeight);
+
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mTexture;
+    int mCapacityWidth;
+    int mCapacityHeight;
+    int mWidth;
+    int mHeight;
+    std::vector<Uint32> mShadow;
+    Stats mStats;
+};
+
+#endif // DYNAMIC_TEXTURE_H
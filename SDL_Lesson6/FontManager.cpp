@@ -0,0 +1,93 @@
+#include "FontManager.h"
+
+#include <climits>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+FontManager::FontManager(const ResourcePack *pPack) :
+  mPack(pPack)
+{
+}
+
+FontManager::~FontManager(void) {
+  clear();
+}
+
+void FontManager::clear(void) {
+  for (std::pair<const Key, TTF_Font *> &font : mFonts) {
+    TTF_CloseFont(font.second);
+  }
+  mFonts.clear();
+  mFiles.clear();
+}
+
+int FontManager::fontCount(void) const {
+  return mFonts.size();
+}
+
+const std::vector<char> *FontManager::load(const std::string &pPath) {
+  std::map<std::string, std::vector<char> >::const_iterator found = mFiles.find(pPath);
+  if (mFiles.end() != found) {
+    return &found->second;
+  }
+  SDL_RWops *file = SDL_RWFromFile(pPath.c_str(), "rb");
+  if (nullptr == file) {
+    return nullptr;
+  }
+  Sint64 size = SDL_RWsize(file);
+  std::vector<char> buffer(0 < size ? size : 0);
+  bool complete = 0 < size && 1 == SDL_RWread(file, buffer.data(), buffer.size(), 1);
+  SDL_RWclose(file);
+  if (!complete) {
+    SDL_SetError("Could not read %s", pPath.c_str());
+    return nullptr;
+  }
+  std::vector<char> &result = mFiles[pPath];
+  result.swap(buffer);
+  return &result;
+}
+
+TTF_Font *FontManager::open(const std::string &pPath, int pPointSize) {
+  Key key(pPath, pPointSize);
+  std::map<Key, TTF_Font *>::const_iterator found = mFonts.find(key);
+  if (mFonts.end() != found) {
+    return found->second;
+  }
+  size_t size = 0;
+  const void *data = nullptr == mPack ? nullptr : mPack->find(pPath, &size);
+  if (nullptr == data) {
+    const std::vector<char> *file = load(pPath);
+    if (nullptr == file) {
+      return nullptr;
+    }
+    data = file->data();
+    size = file->size();
+  }
+  SDL_RWops *memory = SDL_RWFromConstMem(data, size);
+  if (nullptr == memory) {
+    return nullptr;
+  }
+  // The font owns the RWops; the bytes it reads are owned here or by the pack.
+  TTF_Font *font = TTF_OpenFontRW(memory, 1, pPointSize);
+  if (nullptr != font) {
+    mFonts[key] = font;
+  }
+  return font;
+}
+
+void FontManager::close(const std::string &pPath, int pPointSize) {
+  std::map<Key, TTF_Font *>::iterator found = mFonts.find(Key(pPath, pPointSize));
+  if (mFonts.end() != found) {
+    TTF_CloseFont(found->second);
+    mFonts.erase(found);
+  }
+}
+
+void FontManager::release(const std::string &pPath) {
+  std::map<Key, TTF_Font *>::iterator it = mFonts.lower_bound(Key(pPath, INT_MIN));
+  while (mFonts.end() != it && pPath == it->first.first) {
+    TTF_CloseFont(it->second);
+    it = mFonts.erase(it);
+  }
+  mFiles.erase(pPath);
+}
@@ -0,0 +1,45 @@
+#ifndef FONT_MANAGER_H
+#define FONT_MANAGER_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL2/SDL_ttf.h>
+
+#include "ResourcePack.h"
+
+/*
+ * Reads each font file into memory once and opens every point size from
+ * that shared buffer.  Fonts found in the resource pack are opened straight
+ * from its mapping instead.  Handles are cached by (path, size) and stay open
+ * until close(), release() or clear(); do not close them with
+ * TTF_CloseFont.
+ */
+class FontManager {
+  public:
+    explicit FontManager(const ResourcePack *pPack = nullptr);
+    ~FontManager(void);
+    FontManager(const FontManager &) = delete;
+    FontManager &operator=(const FontManager &) = delete;
+
+    // Returns nullptr and leaves SDL_GetError set on failure.
+    TTF_Font *open(const std::string &pPath, int pPointSize);
+    // Closes one size; the file stays in memory for other sizes.
+    void close(const std::string &pPath, int pPointSize);
+    // Closes every size of pPath and frees its file buffer.
+    void release(const std::string &pPath);
+    void clear(void);
+    int fontCount(void) const;
+
+  private:
+    typedef std::pair<std::string, int> Key;
+
+    const std::vector<char> *load(const std::string &pPath);
+
+    const ResourcePack *mPack;
+    std::map<std::string, std::vector<char> > mFiles;
+    std::map<Key, TTF_Font *> mFonts;
+};
+
+#endif // FONT_MANAGER_H
@@ -0,0 +1,67 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <SDL2/SDL.h>
+
+enum class FrameMode {
+  // One frame per period, paced to the target rate.
+  Paced,
+  // No pacing at all, for benchmarking.
+  Uncapped
+};
+
+/*
+ * Paces the main loop against SDL_GetPerformanceCounter.  Deadlines advance
+ * by exactly one period so the rate does not drift, and endFrame() sleeps
+ * for most of the remaining time before spinning out the last moment.
+ *
+ * In event-driven mode a frame is only pending when the loop has called
+ * invalidate() (for input, or while anything animates) or a wakeAt()
+ * deadline has passed.  Otherwise waitForWork() blocks in
+ * SDL_WaitEventTimeout until either happens, so an idle loop uses no CPU.
+ */
+class FrameScheduler {
+  public:
+    explicit FrameScheduler(int pFramesPerSecond, FrameMode pMode = FrameMode::Paced);
+
+    // Starts a frame and samples the clock for time().
+    void beginFrame(void);
+    // Waits for the next frame deadline unless the mode is Uncapped.
+    void endFrame(void);
+
+    // Animation time in seconds for the frame being rendered.
+    double time(void) const;
+    // Wall time taken by the previous frame, in seconds.
+    double frameSeconds(void) const;
+    FrameMode mode(void) const;
+    void setMode(FrameMode pMode);
+
+    bool eventDriven(void) const;
+    void setEventDriven(bool pEnabled);
+    // The current frame needs rendering.
+    void invalidate(void);
+    // A frame is needed once time() reaches pSeconds; the earliest wins.
+    void wakeAt(double pSeconds);
+    // True unless event-driven with nothing invalidated or due.
+    bool pending(void) const;
+    // In event-driven mode with nothing pending, blocks until an event is
+    // queued (it is left for SDL_PollEvent) or the next wakeAt() deadline.
+    void waitForWork(void);
+
+  private:
+    double seconds(Uint64 pTicks) const;
+
+    FrameMode mMode;
+    Uint64 mFrequency;
+    Uint64 mPeriod;
+    Uint64 mStart;
+    Uint64 mFrameStart;
+    Uint64 mDeadline;
+    Uint64 mLastFrame;
+    Uint64 mNow;
+    bool mEventDriven;
+    bool mInvalid;
+    Uint64 mWake;
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,265 @@
+#include "GlyphCache.h"
+
+#include <algorithm>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "Utility.h"
+
+// Placement relies on TTF_RenderGlyph_Blended returning a full-line surface
+// with the bearings applied, which older SDL_ttf releases do not.
+#if SDL_VERSIONNUM(SDL_TTF_MAJOR_VERSION, SDL_TTF_MINOR_VERSION, SDL_TTF_PATCHLEVEL) < SDL_VERSIONNUM(2, 0, 18)
+  #error "GlyphCache requires SDL_ttf 2.0.18 or newer"
+#endif
+
+namespace {
+  const int PADDING = 1;
+  const SDL_Color WHITE = {0xFF, 0xFF, 0xFF, 0xFF};
+}
+
+GlyphCache::GlyphCache(SDL_Renderer *pRenderer, int pAtlasSize) :
+  mRenderer(pRenderer),
+  mBatch(pRenderer),
+  mTexture(nullptr),
+  mAtlasSize(pAtlasSize)
+{
+}
+
+GlyphCache::~GlyphCache(void) {
+  clear();
+}
+
+void GlyphCache::clear(void) {
+  Utility::cleanup(mTexture);
+  mTexture = nullptr;
+  mShelves.clear();
+  mGlyphs.clear();
+}
+
+int GlyphCache::glyphCount(void) const {
+  return mGlyphs.size();
+}
+
+size_t GlyphCache::textureBytes(void) const {
+  return nullptr == mTexture ? 0 : (size_t)mAtlasSize * mAtlasSize * sizeof(Uint32);
+}
+
+void GlyphCache::forget(TTF_Font *pFont) {
+  std::map<Key, Glyph>::iterator it = mGlyphs.lower_bound(Key(pFont, 0));
+  while (mGlyphs.end() != it && pFont == it->first.first) {
+    it = mGlyphs.erase(it);
+  }
+}
+
+void GlyphCache::reset(void) {
+  // Quads already queued still reference the old atlas contents.
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  if (nullptr != batch) {
+    batch->flush();
+  }
+  mShelves.clear();
+  mGlyphs.clear();
+}
+
+bool GlyphCache::allocate(int pWidth, int pHeight, SDL_Rect &pRegion) {
+  int width = pWidth + PADDING;
+  int height = pHeight + PADDING;
+  if (mAtlasSize < width || mAtlasSize < height) {
+    return false;
+  }
+  Shelf *best = nullptr;
+  for (Shelf &shelf : mShelves) {
+    if (height <= shelf.height && width <= mAtlasSize - shelf.used && (nullptr == best || shelf.height < best->height)) {
+      best = &shelf;
+    }
+  }
+  if (nullptr == best) {
+    int top = mShelves.empty() ? 0 : mShelves.back().y + mShelves.back().height;
+    if (mAtlasSize < top + height) {
+      return false;
+    }
+    Shelf shelf = {top, height, 0};
+    mShelves.push_back(shelf);
+    best = &mShelves.back();
+  }
+  pRegion.x = best->used;
+  pRegion.y = best->y;
+  pRegion.w = pWidth;
+  pRegion.h = pHeight;
+  best->used += width;
+  return true;
+}
+
+bool GlyphCache::rasterize(TTF_Font *pFont, Uint16 pCharacter, Glyph &pGlyph) {
+  if (nullptr == mTexture) {
+    mTexture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, mAtlasSize, mAtlasSize);
+    if (nullptr == mTexture) {
+      return false;
+    }
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+  }
+  // Only the advance is needed: TTF_RenderGlyph_Blended lays the glyph out
+  // as a one-character string, so its surface is already a full line high
+  // with the bearings and baseline applied relative to the pen position.
+  if (0 != TTF_GlyphMetrics(pFont, pCharacter, nullptr, nullptr, nullptr, nullptr, &pGlyph.advance)) {
+    return false;
+  }
+  // Rendered white so the vertex colour tints it to any text colour.
+  SDL_Surface *rendered = TTF_RenderGlyph_Blended(pFont, pCharacter, WHITE);
+  if (nullptr == rendered) {
+    return false;
+  }
+  SDL_Surface *glyph = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+  Utility::cleanup(rendered);
+  if (nullptr == glyph) {
+    return false;
+  }
+  if (!allocate(glyph->w, glyph->h, pGlyph.region)) {
+    reset();
+    if (!allocate(glyph->w, glyph->h, pGlyph.region)) {
+      Utility::cleanup(glyph);
+      return false;
+    }
+  }
+  SDL_UpdateTexture(mTexture, &pGlyph.region, glyph->pixels, glyph->pitch);
+  pGlyph.pixels.reset(glyph, Utility::Deleter());
+  return true;
+}
+
+const GlyphCache::Glyph *GlyphCache::find(TTF_Font *pFont, Uint16 pCharacter) {
+  Key key(pFont, pCharacter);
+  std::map<Key, Glyph>::const_iterator it = mGlyphs.find(key);
+  if (mGlyphs.end() != it) {
+    return &it->second;
+  }
+  Glyph glyph;
+  if (!rasterize(pFont, pCharacter, glyph)) {
+    return nullptr;
+  }
+  return &(mGlyphs[key] = glyph);
+}
+
+bool GlyphCache::preload(TTF_Font *pFont, const std::string &pCharacters) {
+  bool result = true;
+  for (unsigned char character : pCharacters) {
+    result = nullptr != find(pFont, character) && result;
+  }
+  return result;
+}
+
+void GlyphCache::size(const std::string &pMessage, TTF_Font *pFont, int *pWidth, int *pHeight) {
+  int width = 0;
+  Uint16 previous = 0;
+  for (unsigned char character : pMessage) {
+    const Glyph *glyph = find(pFont, character);
+    if (nullptr == glyph) {
+      continue;
+    }
+    if (0 != previous) {
+      width += TTF_GetFontKerningSizeGlyphs(pFont, previous, character);
+    }
+    width += glyph->advance;
+    previous = character;
+  }
+  if (nullptr != pWidth) {
+    *pWidth = width;
+  }
+  if (nullptr != pHeight) {
+    *pHeight = TTF_FontHeight(pFont);
+  }
+}
+
+void GlyphCache::layout(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  SDL_Color pColor,
+  float pX,
+  float pY,
+  float pScaleX,
+  float pScaleY
+) {
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  bool ownBatch = nullptr == batch;
+  if (ownBatch) {
+    batch = &mBatch;
+    batch->begin();
+  }
+  float penX = pX;
+  Uint16 previous = 0;
+  for (unsigned char character : pMessage) {
+    const Glyph *glyph = find(pFont, character);
+    if (nullptr == glyph) {
+      continue;
+    }
+    if (0 != previous) {
+      penX += TTF_GetFontKerningSizeGlyphs(pFont, previous, character) * pScaleX;
+    }
+    SDL_Rect destination = {
+      (int)penX,
+      (int)pY,
+      (int)(glyph->region.w * pScaleX + 0.5f),
+      (int)(glyph->region.h * pScaleY + 0.5f)
+    };
+    batch->draw(mTexture, destination, &glyph->region, pColor);
+    penX += glyph->advance * pScaleX;
+    previous = character;
+  }
+  if (ownBatch) {
+    batch->end();
+  }
+}
+
+void GlyphCache::draw(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, int pPositionX, int pPositionY) {
+  layout(pMessage, pFont, pColor, pPositionX, pPositionY, 1.0f, 1.0f);
+}
+
+void GlyphCache::draw(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, SDL_Rect pDestination) {
+  int width, height;
+  size(pMessage, pFont, &width, &height);
+  if (0 < width && 0 < height) {
+    layout(pMessage, pFont, pColor, pDestination.x, pDestination.y, (float)pDestination.w / width, (float)pDestination.h / height);
+  }
+}
+
+SDL_Surface *GlyphCache::render(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, SurfacePool &pPool) {
+  int width, height;
+  size(pMessage, pFont, &width, &height);
+  width = std::max(width, 1);
+  height = std::max(height, 1);
+  SDL_Surface *surface = pPool.acquire(width, height);
+  if (nullptr == surface) {
+    return nullptr;
+  }
+  // Fills the clip rectangle, which the pool set to the string's size.
+  SDL_FillRect(surface, nullptr, 0);
+  Uint32 color = (Uint32)pColor.r << 16 | (Uint32)pColor.g << 8 | pColor.b;
+  int penX = 0;
+  Uint16 previous = 0;
+  for (unsigned char character : pMessage) {
+    const Glyph *glyph = find(pFont, character);
+    if (nullptr == glyph) {
+      continue;
+    }
+    if (0 != previous) {
+      penX += TTF_GetFontKerningSizeGlyphs(pFont, previous, character);
+    }
+    const SDL_Surface *pixels = glyph->pixels.get();
+    int left = std::max(0, -penX);
+    int right = std::min(pixels->w, width - penX);
+    int bottom = std::min(pixels->h, height);
+    for (int y = 0; y < bottom; y++) {
+      const Uint32 *source = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(pixels->pixels) + y * pixels->pitch);
+      Uint32 *target = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(surface->pixels) + y * surface->pitch) + penX;
+      for (int x = left; x < right; x++) {
+        // Where kerned glyphs overlap, the stronger coverage wins.
+        Uint32 alpha = (source[x] >> 24) * pColor.a / 255;
+        if ((target[x] >> 24) < alpha) {
+          target[x] = alpha << 24 | color;
+        }
+      }
+    }
+    penX += glyph->advance;
+    previous = character;
+  }
+  return surface;
+}
@@ -0,0 +1,80 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "SpriteBatch.h"
+#include "SurfacePool.h"
+
+/*
+ * Rasterizes each (font, glyph) pair once into a shared atlas texture and
+ * draws strings as batches of atlas quads.  The glyph pixels are also kept
+ * on the CPU, so render() can compose a string into a pooled surface
+ * without calling into SDL_ttf.  Each glyph surface is placed at the pen
+ * position unadjusted: this relies on TTF_RenderGlyph_Blended padding it
+ * to a full line with the bearings and baseline already applied.  A
+ * TTF_Font handle is opened at a single point size, so the font pointer
+ * keys both face and size.  Fonts must outlive the cache entries that
+ * reference them; call forget() before closing a font.
+ */
+class GlyphCache {
+  public:
+    explicit GlyphCache(SDL_Renderer *pRenderer, int pAtlasSize = 1024);
+    ~GlyphCache(void);
+    GlyphCache(const GlyphCache &) = delete;
+    GlyphCache &operator=(const GlyphCache &) = delete;
+
+    // Rasterizes every glyph in pCharacters ahead of time.
+    bool preload(TTF_Font *pFont, const std::string &pCharacters);
+    // Size of pMessage as TTF_RenderText_Blended would lay it out.
+    void size(const std::string &pMessage, TTF_Font *pFont, int *pWidth, int *pHeight);
+    void draw(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, int pPositionX, int pPositionY);
+    // Stretches the laid-out string to fill pDestination.
+    void draw(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, SDL_Rect pDestination);
+    // Lays pMessage out as draw() does into a surface from pPool, which the
+    // caller releases back to it.  The surface may be larger than the
+    // string; its clip rectangle holds the string's size.  Returns nullptr
+    // and leaves SDL_GetError set on failure.
+    SDL_Surface *render(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, SurfacePool &pPool);
+    void forget(TTF_Font *pFont);
+    void clear(void);
+    int glyphCount(void) const;
+    // Size of the atlas texture, once created.
+    size_t textureBytes(void) const;
+
+  private:
+    struct Glyph {
+      SDL_Rect region;
+      int advance;
+      // White ARGB8888 coverage, as uploaded to the atlas.
+      std::shared_ptr<SDL_Surface> pixels;
+    };
+    struct Shelf {
+      int y;
+      int height;
+      int used;
+    };
+    typedef std::pair<TTF_Font *, Uint16> Key;
+
+    const Glyph *find(TTF_Font *pFont, Uint16 pCharacter);
+    bool rasterize(TTF_Font *pFont, Uint16 pCharacter, Glyph &pGlyph);
+    bool allocate(int pWidth, int pHeight, SDL_Rect &pRegion);
+    void reset(void);
+    void layout(const std::string &pMessage, TTF_Font *pFont, SDL_Color pColor, float pX, float pY, float pScaleX, float pScaleY);
+
+    SDL_Renderer *mRenderer;
+    SpriteBatch mBatch;
+    SDL_Texture *mTexture;
+    int mAtlasSize;
+    std::vector<Shelf> mShelves;
+    std::map<Key, Glyph> mGlyphs;
+};
+
+#endif // GLYPH_CACHE_H
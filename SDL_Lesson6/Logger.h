@@ -0,0 +1,98 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <SDL2/SDL.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define LOGGER_PRINTF(FORMAT, ARGUMENTS) __attribute__((format(printf, FORMAT, ARGUMENTS)))
+#else
+  #define LOGGER_PRINTF(FORMAT, ARGUMENTS)
+#endif
+
+enum class LogLevel {
+  Debug,
+  Info,
+  Warning,
+  Error
+};
+
+/*
+ * Asynchronous logger.  log() formats into a preallocated record of a
+ * bounded lock-free ring and returns; a background thread writes the
+ * records to the stream and flushes it, so callers never wait on I/O and
+ * never allocate.  When the ring is full the new message is dropped, and
+ * once it is three-quarters full only errors are accepted.  Messages below
+ * Error are also rate limited per second.  Dropped messages are counted and
+ * reported by the writer thread.
+ */
+class Logger {
+  public:
+    // Longest message, including the terminator; longer ones are truncated.
+    static const int MESSAGE_SIZE = 256;
+
+    // pCapacity is rounded up to a power of two.
+    explicit Logger(std::ostream &pOutputStream, int pCapacity = 256, int pMessagesPerSecond = 100);
+    ~Logger(void);
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    // Returns false if the message was filtered, rate limited or dropped.
+    bool log(LogLevel pLevel, const char *pFormat, ...) LOGGER_PRINTF(3, 4);
+    bool logv(LogLevel pLevel, const char *pFormat, va_list pArguments);
+    // Logs each line of pText as its own message.
+    void write(LogLevel pLevel, const std::string &pText);
+    // Blocks until everything logged so far has been written.
+    void flush(void);
+
+    void setLevel(LogLevel pLevel);
+    LogLevel level(void) const;
+    unsigned long dropped(void) const;
+    unsigned long rateLimited(void) const;
+
+    // The process-wide logger on std::cout, started on first use.
+    static Logger &console(void);
+
+  private:
+    struct Record {
+      std::atomic<size_t> sequence;
+      char text[MESSAGE_SIZE];
+    };
+
+    // A free record for pLevel, or nullptr if the message must be dropped.
+    Record *acquire(LogLevel pLevel, size_t &pPosition);
+    void publish(Record *pRecord, size_t pPosition);
+    bool admit(LogLevel pLevel);
+    void work(void);
+    // Writes every published record; returns how many.
+    size_t drain(void);
+
+    std::ostream &mOutputStream;
+    std::unique_ptr<Record[]> mRecords;
+    size_t mMask;
+    std::atomic<size_t> mEnqueue;
+    std::atomic<size_t> mDequeue;
+    std::atomic<int> mLevel;
+    int mMessagesPerSecond;
+    Uint64 mFrequency;
+    std::atomic<Uint64> mWindow;
+    std::atomic<int> mWindowCount;
+    std::atomic<unsigned long> mDropped;
+    std::atomic<unsigned long> mRateLimited;
+    unsigned long mReportedDropped;
+    unsigned long mReportedRateLimited;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mFlushed;
+    bool mStopping;
+    std::thread mThread;
+};
+
+#endif // LOGGER_H
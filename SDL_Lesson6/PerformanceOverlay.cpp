@@ -0,0 +1,155 @@
+#include "PerformanceOverlay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+namespace {
+  const int PADDING = 4;
+  const int GRAPH_HEIGHT = 48;
+  const int LINES = 5;
+  // The graph's top edge is this many target periods.
+  const double GRAPH_PERIODS = 2.0;
+  // Frames up to this much over the target still count as on time.
+  const double SLACK = 1.05;
+  const SDL_Color PANEL = {0x00, 0x00, 0x00, 0xB0};
+  const SDL_Color TARGET = {0xFF, 0xFF, 0xFF, 0x60};
+  const SDL_Color ON_TIME = {0x40, 0xD0, 0x40, 0xFF};
+  const SDL_Color LATE = {0xE0, 0xC0, 0x30, 0xFF};
+  const SDL_Color MISSED = {0xE0, 0x40, 0x40, 0xFF};
+  const SDL_Color TEXT = {0xFF, 0xFF, 0xFF, 0xFF};
+}
+
+PerformanceOverlay::PerformanceOverlay(SDL_Renderer *pRenderer, GlyphCache &pGlyphs, TTF_Font *pFont, int pFramesPerSecond) :
+  mRenderer(pRenderer),
+  mGlyphs(pGlyphs),
+  mFont(pFont),
+  mBatch(pRenderer),
+  mTargetSeconds(1.0 / pFramesPerSecond),
+  mVisible(false),
+  mHistory(),
+  mNext(0),
+  mCount(0),
+  mLast(),
+  mFrequency(SDL_GetPerformanceFrequency()),
+  mDrawSeconds(0.0)
+{
+  // The panel, the target line and a bar per frame.
+  mVertices.reserve(4 * (HISTORY + 2));
+  mIndices.reserve(6 * (HISTORY + 2));
+}
+
+bool PerformanceOverlay::visible(void) const {
+  return mVisible;
+}
+
+void PerformanceOverlay::setVisible(bool pVisible) {
+  mVisible = pVisible;
+}
+
+void PerformanceOverlay::toggle(void) {
+  mVisible = !mVisible;
+}
+
+int PerformanceOverlay::width(void) const {
+  return HISTORY + 2 * PADDING;
+}
+
+void PerformanceOverlay::record(const Frame &pFrame) {
+  mHistory[mNext] = (float)pFrame.seconds;
+  mNext = (mNext + 1) % HISTORY;
+  if (mCount < HISTORY) {
+    mCount++;
+  }
+  mLast = pFrame;
+}
+
+void PerformanceOverlay::quad(float pLeft, float pTop, float pRight, float pBottom, SDL_Color pColor) {
+  int base = mVertices.size();
+  SDL_Vertex corners[4] = {
+    {{pLeft, pTop}, pColor, {0.0f, 0.0f}},
+    {{pRight, pTop}, pColor, {0.0f, 0.0f}},
+    {{pRight, pBottom}, pColor, {0.0f, 0.0f}},
+    {{pLeft, pBottom}, pColor, {0.0f, 0.0f}}
+  };
+  mVertices.insert(mVertices.end(), corners, corners + 4);
+  const int indices[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+  mIndices.insert(mIndices.end(), indices, indices + 6);
+}
+
+void PerformanceOverlay::draw(int pPositionX, int pPositionY) {
+  if (!mVisible) {
+    return;
+  }
+  Uint64 start = SDL_GetPerformanceCounter();
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  bool ownBatch = nullptr == batch;
+  if (ownBatch) {
+    batch = &mBatch;
+  } else {
+    batch->flush();
+  }
+
+  // Frame rate over roughly the last second; the average and worst frame
+  // over the whole graph.
+  double recent = 0.0;
+  int recentFrames = 0;
+  double total = 0.0;
+  double worst = 0.0;
+  for (int i = 1; i <= mCount; i++) {
+    double seconds = mHistory[(mNext - i + HISTORY) % HISTORY];
+    if (recent < 1.0) {
+      recent += seconds;
+      recentFrames++;
+    }
+    total += seconds;
+    worst = std::max(worst, seconds);
+  }
+
+  int lineHeight = TTF_FontHeight(mFont);
+  float left = pPositionX;
+  float top = pPositionY;
+  float graphTop = top + PADDING + LINES * lineHeight + PADDING;
+  float graphBottom = graphTop + GRAPH_HEIGHT;
+  float scale = GRAPH_HEIGHT / (GRAPH_PERIODS * mTargetSeconds);
+  mVertices.clear();
+  mIndices.clear();
+  quad(left, top, left + width(), graphBottom + PADDING, PANEL);
+  float targetY = graphBottom - (float)(mTargetSeconds * scale);
+  quad(left + PADDING, targetY, left + PADDING + HISTORY, targetY + 1, TARGET);
+  // Oldest on the left, so the newest frame is at the right-hand edge.
+  float barX = left + PADDING + HISTORY - mCount;
+  for (int i = mCount; 0 < i; i--) {
+    double seconds = mHistory[(mNext - i + HISTORY) % HISTORY];
+    float height = (float)std::min(seconds * scale, (double)GRAPH_HEIGHT);
+    SDL_Color color = seconds <= mTargetSeconds * SLACK ? ON_TIME
+      : seconds <= GRAPH_PERIODS * mTargetSeconds ? LATE : MISSED;
+    quad(barX, graphBottom - height, barX + 1, graphBottom, color);
+    barX++;
+  }
+  // Untextured geometry blends with the renderer's draw blend mode.
+  SDL_BlendMode blendMode;
+  SDL_GetRenderDrawBlendMode(mRenderer, &blendMode);
+  SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+  SDL_RenderGeometry(mRenderer, nullptr, mVertices.data(), mVertices.size(), mIndices.data(), mIndices.size());
+  SDL_SetRenderDrawBlendMode(mRenderer, blendMode);
+
+  char lines[LINES][64];
+  snprintf(lines[0], sizeof(lines[0]), "%.1f fps", 0.0 < recent ? recentFrames / recent : 0.0);
+  snprintf(lines[1], sizeof(lines[1]), "%.2f ms, max %.2f", 0 < mCount ? total * 1000.0 / mCount : 0.0, worst * 1000.0);
+  snprintf(lines[2], sizeof(lines[2]), "%d draws, %d switches", mLast.drawCalls, mLast.textureSwitches);
+  snprintf(lines[3], sizeof(lines[3]), "%.1f MiB textures", mLast.textureBytes / (1024.0 * 1024.0));
+  snprintf(lines[4], sizeof(lines[4]), "overlay %.3f ms", mDrawSeconds * 1000.0);
+  if (ownBatch) {
+    batch->begin();
+  }
+  for (int i = 0; i < LINES; i++) {
+    mGlyphs.draw(lines[i], mFont, TEXT, pPositionX + PADDING, pPositionY + PADDING + i * lineHeight);
+  }
+  if (ownBatch) {
+    batch->end();
+  }
+  mDrawSeconds = (double)(SDL_GetPerformanceCounter() - start) / mFrequency;
+}
@@ -0,0 +1,68 @@
+#ifndef PERFORMANCE_OVERLAY_H
+#define PERFORMANCE_OVERLAY_H
+
+#include <cstddef>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "GlyphCache.h"
+#include "SpriteBatch.h"
+
+/*
+ * A heads-up display of the loop's own statistics, drawn over the finished
+ * scene: frames per second, a graph of the recent frame times against the
+ * target period, the scene's draw calls and texture switches, and texture
+ * memory.  The panel and graph are one SDL_RenderGeometry call of
+ * untextured quads and the text is one batch of cached glyphs, so the
+ * overlay uploads nothing.  The time the previous draw() took is shown
+ * as well.
+ */
+class PerformanceOverlay {
+  public:
+    struct Frame {
+      // Wall time of the frame, from FrameScheduler::frameSeconds().
+      double seconds;
+      int drawCalls;
+      int textureSwitches;
+      size_t textureBytes;
+    };
+
+    PerformanceOverlay(SDL_Renderer *pRenderer, GlyphCache &pGlyphs, TTF_Font *pFont, int pFramesPerSecond);
+    PerformanceOverlay(const PerformanceOverlay &) = delete;
+    PerformanceOverlay &operator=(const PerformanceOverlay &) = delete;
+
+    bool visible(void) const;
+    void setVisible(bool pVisible);
+    void toggle(void);
+    // Call once per frame, shown or not, so the graph has no gaps.
+    void record(const Frame &pFrame);
+    // Draws the panel with its top-left corner at pPositionX, pPositionY.
+    // Quads already queued on the current SpriteBatch are flushed first so
+    // they stay underneath.
+    void draw(int pPositionX, int pPositionY);
+    int width(void) const;
+
+  private:
+    // Frames in the graph, one pixel column each.
+    static const int HISTORY = 240;
+
+    void quad(float pLeft, float pTop, float pRight, float pBottom, SDL_Color pColor);
+
+    SDL_Renderer *mRenderer;
+    GlyphCache &mGlyphs;
+    TTF_Font *mFont;
+    SpriteBatch mBatch;
+    double mTargetSeconds;
+    bool mVisible;
+    float mHistory[HISTORY];
+    int mNext;
+    int mCount;
+    Frame mLast;
+    Uint64 mFrequency;
+    double mDrawSeconds;
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+};
+
+#endif // PERFORMANCE_OVERLAY_H
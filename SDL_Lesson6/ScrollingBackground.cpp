@@ -0,0 +1,119 @@
+#include "ScrollingBackground.h"
+
+#include <algorithm>
+#include <SDL2/SDL.h>
+
+#include "CpuCanvas.h"
+#include "SpriteBatch.h"
+#include "Utility.h"
+
+namespace {
+  int wrap(int pValue, int pPeriod) {
+    int result = pValue % pPeriod;
+    return result < 0 ? result + pPeriod : result;
+  }
+
+  void copy(SDL_Renderer *pRenderer, SDL_Texture *pTexture, const SDL_Rect &pSource, const SDL_Rect &pDestination) {
+    CpuCanvas *canvas = CpuCanvas::current(pRenderer);
+    if (nullptr != canvas && canvas->draw(pTexture, pDestination, &pSource)) {
+      return;
+    }
+    SpriteBatch *batch = SpriteBatch::current(pRenderer);
+    if (nullptr == batch) {
+      SDL_RenderCopy(pRenderer, pTexture, &pSource, &pDestination);
+    } else {
+      batch->draw(pTexture, pDestination, &pSource);
+    }
+  }
+}
+
+ScrollingBackground::ScrollingBackground(void) :
+  mTexture(nullptr),
+  mWidth(0),
+  mHeight(0),
+  mViewWidth(0),
+  mViewHeight(0)
+{
+}
+
+ScrollingBackground::~ScrollingBackground(void) {
+  clear();
+}
+
+void ScrollingBackground::clear(void) {
+  Utility::cleanup(mTexture);
+  mTexture = nullptr;
+}
+
+bool ScrollingBackground::ready(void) const {
+  return nullptr != mTexture;
+}
+
+size_t ScrollingBackground::textureBytes(void) const {
+  return nullptr == mTexture ? 0 : (size_t)mWidth * mHeight * sizeof(Uint32);
+}
+
+bool ScrollingBackground::build(
+  SDL_Renderer *pRenderer,
+  SDL_Texture *pTile,
+  const SDL_Rect *pClip,
+  int pTileWidth,
+  int pTileHeight,
+  int pViewWidth,
+  int pViewHeight
+) {
+  clear();
+  if (!SDL_RenderTargetSupported(pRenderer) || pTileWidth <= 0 || pTileHeight <= 0) {
+    return false;
+  }
+  // Whole periods only, so the pattern is seamless where the texture wraps.
+  mWidth = (pViewWidth / pTileWidth + 2) * pTileWidth;
+  mHeight = (pViewHeight / pTileHeight + 2) * pTileHeight;
+  mViewWidth = pViewWidth;
+  mViewHeight = pViewHeight;
+  mTexture = SDL_CreateTexture(pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, mWidth, mHeight);
+  if (nullptr == mTexture) {
+    return false;
+  }
+
+  SDL_Texture *previousTarget = SDL_GetRenderTarget(pRenderer);
+  SDL_SetRenderTarget(pRenderer, mTexture);
+  // The background covers the whole view, so bake in the clear colour.
+  SDL_RenderClear(pRenderer);
+  for (int y = 0; y < mHeight; y += pTileHeight) {
+    for (int x = 0; x < mWidth; x += pTileWidth) {
+      SDL_Rect destination = {x, y, pTileWidth, pTileHeight};
+      SDL_RenderCopy(pRenderer, pTile, pClip, &destination);
+    }
+  }
+  SDL_SetRenderTarget(pRenderer, previousTarget);
+  SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_NONE);
+  return true;
+}
+
+void ScrollingBackground::render(SDL_Renderer *pRenderer, int pOffsetX, int pOffsetY) const {
+  if (nullptr == mTexture) {
+    return;
+  }
+  int sourceX = wrap(-pOffsetX, mWidth);
+  int sourceY = wrap(-pOffsetY, mHeight);
+  int firstWidth = std::min(mViewWidth, mWidth - sourceX);
+  int firstHeight = std::min(mViewHeight, mHeight - sourceY);
+  const int columns[2][3] = {
+    {sourceX, 0, firstWidth},
+    {0, firstWidth, mViewWidth - firstWidth}
+  };
+  const int rows[2][3] = {
+    {sourceY, 0, firstHeight},
+    {0, firstHeight, mViewHeight - firstHeight}
+  };
+  for (const int *row : rows) {
+    for (const int *column : columns) {
+      if (0 < column[2] && 0 < row[2]) {
+        SDL_Rect source = {column[0], row[0], column[2], row[2]};
+        SDL_Rect destination = {column[1], row[1], column[2], row[2]};
+        copy(pRenderer, mTexture, source, destination);
+      }
+    }
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef SCROLLING_BACKGROUND_H
+#define SCROLLING_BACKGROUND_H
+
+#include <cstddef>
+#include <SDL2/SDL.h>
+
+/*
+ * A tiled background composed once into a render-target texture at least
+ * one tile period larger than the view.  Scrolling it costs at most four
+ * copies per frame regardless of how many tiles are visible.
+ */
+class ScrollingBackground {
+  public:
+    ScrollingBackground(void);
+    ~ScrollingBackground(void);
+    ScrollingBackground(const ScrollingBackground &) = delete;
+    ScrollingBackground &operator=(const ScrollingBackground &) = delete;
+
+    // Returns false if the renderer cannot render to textures.
+    bool build(
+      SDL_Renderer *pRenderer,
+      SDL_Texture *pTile,
+      const SDL_Rect *pClip,
+      int pTileWidth,
+      int pTileHeight,
+      int pViewWidth,
+      int pViewHeight
+    );
+    // Draws the view with the tile grid origin at (pOffsetX, pOffsetY).
+    void render(SDL_Renderer *pRenderer, int pOffsetX, int pOffsetY) const;
+    bool ready(void) const;
+    size_t textureBytes(void) const;
+    void clear(void);
+
+  private:
+    SDL_Texture *mTexture;
+    int mWidth;
+    int mHeight;
+    int mViewWidth;
+    int mViewHeight;
+};
+
+#endif // SCROLLING_BACKGROUND_H
@@ -0,0 +1,74 @@
+#ifndef SOFTWARE_BLITTER_H
+#define SOFTWARE_BLITTER_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+enum class BlitLevel {
+  Scalar,
+  SSE2,
+  AVX2
+};
+
+enum class ScaleFilter {
+  Nearest,
+  Bilinear
+};
+
+/*
+ * CPU kernels for ARGB8888 surfaces: alpha-blended or opaque copy, nearest
+ * and bilinear scaled copy, and fill.  Each level's row kernels produce the
+ * same bits as the scalar ones.  The constructor picks the best level the
+ * CPU reports through SDL's CPUID wrappers; setLevel() can force a lower one.
+ * Blending is SDL_BLENDMODE_BLEND on straight (non-premultiplied) alpha.
+ */
+class SoftwareBlitter {
+  public:
+    SoftwareBlitter(void);
+
+    static BlitLevel detect(void);
+    static const char *name(BlitLevel pLevel);
+    // Returns false if pLevel is not available on this CPU or build.
+    bool setLevel(BlitLevel pLevel);
+    BlitLevel level(void) const;
+
+    // Copies pSourceRect (nullptr for the whole source) to pDestinationRect
+    // (nullptr for the whole destination), scaling with pFilter when the sizes
+    // differ and clipping to the destination's clip rectangle.  Both surfaces
+    // must be SDL_PIXELFORMAT_ARGB8888; otherwise returns false and sets
+    // SDL_GetError.
+    bool blit(
+      SDL_Surface *pSource,
+      const SDL_Rect *pSourceRect,
+      SDL_Surface *pDestination,
+      const SDL_Rect *pDestinationRect,
+      ScaleFilter pFilter = ScaleFilter::Nearest,
+      bool pBlend = true
+    );
+    bool fill(SDL_Surface *pDestination, const SDL_Rect *pRect, Uint32 pColor);
+
+  private:
+    typedef void (*BlendRow)(const Uint32 *pSource, Uint32 *pDestination, int pCount);
+    typedef void (*FillRow)(Uint32 *pDestination, int pCount, Uint32 pColor);
+    typedef void (*BilinearRow)(
+      const Uint32 *pTop,
+      const Uint32 *pBottom,
+      int pWeightY,
+      const int *pColumns,
+      const int *pWeightsX,
+      Uint32 *pOutput,
+      int pCount
+    );
+
+    void writeRow(const Uint32 *pSource, Uint32 *pDestination, int pCount, bool pBlend) const;
+
+    BlitLevel mLevel;
+    BlendRow mBlendRow;
+    FillRow mFillRow;
+    BilinearRow mBilinearRow;
+    std::vector<Uint32> mRow;
+    std::vector<int> mColumns;
+    std::vector<int> mWeights;
+};
+
+#endif // SOFTWARE_BLITTER_H
@@ -0,0 +1,91 @@
+#include "SurfacePool.h"
+
+#include <cstdint>
+#include <SDL2/SDL.h>
+
+namespace {
+  // The smallest class in each dimension, 16 pixels.
+  const int MIN_CLASS = 4;
+
+  // The power of two holding pSize, up to pLimit.
+  int sizeClass(int pSize, int pLimit) {
+    int result = MIN_CLASS;
+    while (result < pLimit && (1 << result) < pSize) {
+      result++;
+    }
+    return result;
+  }
+}
+
+SurfacePool::SurfacePool(void) :
+  mStats()
+{
+}
+
+SurfacePool::~SurfacePool(void) {
+  clear();
+}
+
+void SurfacePool::clear(void) {
+  for (std::vector<SDL_Surface *> &surfaces : mFree) {
+    for (SDL_Surface *surface : surfaces) {
+      mStats.bytes -= (size_t)surface->pitch * surface->h;
+      SDL_FreeSurface(surface);
+    }
+    surfaces.clear();
+  }
+}
+
+SDL_Surface *SurfacePool::acquire(int pWidth, int pHeight, Uint32 pFormat) {
+  if (pWidth <= 0 || pHeight <= 0) {
+    SDL_SetError("SurfacePool: invalid size %dx%d", pWidth, pHeight);
+    return nullptr;
+  }
+  int widthClass = sizeClass(pWidth, CLASSES);
+  int heightClass = sizeClass(pHeight, CLASSES);
+  if (CLASSES <= widthClass || CLASSES <= heightClass) {
+    SDL_SetError("SurfacePool: %dx%d is too large", pWidth, pHeight);
+    return nullptr;
+  }
+  mStats.acquires++;
+  SDL_Rect used = {0, 0, pWidth, pHeight};
+  std::vector<SDL_Surface *> &surfaces = mFree[widthClass * CLASSES + heightClass];
+  for (size_t i = 0; i < surfaces.size(); i++) {
+    SDL_Surface *surface = surfaces[i];
+    if (pFormat == surface->format->format) {
+      surfaces[i] = surfaces.back();
+      surfaces.pop_back();
+      SDL_SetClipRect(surface, &used);
+      mStats.reuses++;
+      return surface;
+    }
+  }
+
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+    0,
+    1 << widthClass,
+    1 << heightClass,
+    SDL_BITSPERPIXEL(pFormat),
+    pFormat
+  );
+  if (nullptr == surface) {
+    return nullptr;
+  }
+  mStats.allocations++;
+  mStats.bytes += (size_t)surface->pitch * surface->h;
+  // The size class travels with the surface back to release().
+  surface->userdata = (void *)(intptr_t)(widthClass * CLASSES + heightClass);
+  SDL_SetClipRect(surface, &used);
+  return surface;
+}
+
+void SurfacePool::release(SDL_Surface *pSurface) {
+  if (nullptr == pSurface) {
+    return;
+  }
+  mFree[(intptr_t)pSurface->userdata].push_back(pSurface);
+}
+
+const SurfacePool::Stats &SurfacePool::stats(void) const {
+  return mStats;
+}
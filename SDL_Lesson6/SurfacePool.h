@@ -0,0 +1,48 @@
+#ifndef SURFACE_POOL_H
+#define SURFACE_POOL_H
+
+#include <cstddef>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/*
+ * Recycles surfaces by size class: a power of two in each dimension.
+ * acquire() returns a released surface of the request's class, or creates
+ * one at the full size of the class, and sets its clip rectangle to the
+ * requested size; that top-left region is the part to use.  Surfaces keep
+ * their shape for life, so once the pool has seen a class, requests of any
+ * size within it do no heap allocation.  Every surface must be released
+ * before the pool is destroyed.
+ */
+class SurfacePool {
+  public:
+    struct Stats {
+      unsigned long acquires;
+      // Acquires that reused a released surface.
+      unsigned long reuses;
+      // Surfaces created; constant once the pool is warm.
+      unsigned long allocations;
+      size_t bytes;
+    };
+
+    SurfacePool(void);
+    ~SurfacePool(void);
+    SurfacePool(const SurfacePool &) = delete;
+    SurfacePool &operator=(const SurfacePool &) = delete;
+
+    // Returns nullptr and leaves SDL_GetError set on failure.  The pixels
+    // are not cleared.
+    SDL_Surface *acquire(int pWidth, int pHeight, Uint32 pFormat = SDL_PIXELFORMAT_ARGB8888);
+    void release(SDL_Surface *pSurface);
+    const Stats &stats(void) const;
+    // Frees every released surface.
+    void clear(void);
+
+  private:
+    static const int CLASSES = 16;
+
+    std::vector<SDL_Surface *> mFree[CLASSES * CLASSES];
+    Stats mStats;
+};
+
+#endif // SURFACE_POOL_H
@@ -0,0 +1,122 @@
+#include "TextCache.h"
+
+#include <functional>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "SpriteBatch.h"
+#include "Utility.h"
+
+bool TextCache::Key::operator==(const Key &pOther) const {
+  return font == pOther.font
+    && pointSize == pOther.pointSize
+    && color == pOther.color
+    && mode == pOther.mode
+    && message == pOther.message;
+}
+
+size_t TextCache::KeyHash::operator()(const Key &pKey) const {
+  size_t result = std::hash<std::string>()(pKey.message);
+  result = result * 31 + std::hash<const void *>()(pKey.font);
+  result = result * 31 + pKey.pointSize;
+  result = result * 31 + pKey.color;
+  result = result * 31 + (size_t)pKey.mode;
+  return result;
+}
+
+TextCache::TextCache(SDL_Renderer *pRenderer, size_t pByteBudget) :
+  mRenderer(pRenderer),
+  mByteBudget(pByteBudget),
+  mStats()
+{
+}
+
+TextCache::~TextCache(void) {
+  clear();
+}
+
+void TextCache::clear(void) {
+  SpriteBatch *batch = SpriteBatch::current(mRenderer);
+  if (nullptr != batch) {
+    batch->flush();
+  }
+  for (Entry &entry : mEntries) {
+    Utility::cleanup(entry.texture);
+  }
+  mEntries.clear();
+  mIndex.clear();
+  mStats.bytes = 0;
+  mStats.entries = 0;
+}
+
+const TextCache::Stats &TextCache::stats(void) const {
+  return mStats;
+}
+
+void TextCache::setBudget(size_t pByteBudget) {
+  mByteBudget = pByteBudget;
+  evict(1);
+}
+
+void TextCache::evict(size_t pKeep) {
+  bool flushed = false;
+  while (mByteBudget < mStats.bytes && pKeep < mEntries.size()) {
+    if (!flushed) {
+      // Queued quads may still reference the texture being destroyed.
+      SpriteBatch *batch = SpriteBatch::current(mRenderer);
+      if (nullptr != batch) {
+        batch->flush();
+      }
+      flushed = true;
+    }
+    Entry &oldest = mEntries.back();
+    Utility::cleanup(oldest.texture);
+    mStats.bytes -= oldest.bytes;
+    mIndex.erase(oldest.key);
+    mEntries.pop_back();
+    mStats.evictions++;
+  }
+  mStats.entries = mEntries.size();
+}
+
+SDL_Texture *TextCache::get(
+  const std::string &pMessage,
+  TTF_Font *pFont,
+  int pPointSize,
+  SDL_Color pColor,
+  TextRenderMode pMode
+) {
+  Key key = {
+    pMessage,
+    pFont,
+    pPointSize,
+    (Uint32)pColor.r << 24 | (Uint32)pColor.g << 16 | (Uint32)pColor.b << 8 | pColor.a,
+    pMode
+  };
+  std::unordered_map<Key, Entries::iterator, KeyHash>::iterator found = mIndex.find(key);
+  if (mIndex.end() != found) {
+    mEntries.splice(mEntries.begin(), mEntries, found->second);
+    mStats.hits++;
+    return found->second->texture;
+  }
+  mStats.misses++;
+
+  SDL_Surface *surface = TextRenderMode::Solid == pMode
+    ? TTF_RenderText_Solid(pFont, pMessage.c_str(), pColor)
+    : TTF_RenderText_Blended(pFont, pMessage.c_str(), pColor);
+  if (nullptr == surface) {
+    return nullptr;
+  }
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(mRenderer, surface);
+  size_t bytes = (size_t)surface->w * surface->h * 4;
+  Utility::cleanup(surface);
+  if (nullptr == texture) {
+    return nullptr;
+  }
+  Entry entry = {key, texture, bytes};
+  mEntries.push_front(entry);
+  mIndex[key] = mEntries.begin();
+  mStats.bytes += bytes;
+  evict(1);
+  return texture;
+}
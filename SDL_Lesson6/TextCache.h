@@ -0,0 +1,77 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+enum class TextRenderMode {
+  Solid,
+  Blended
+};
+
+/*
+ * Keeps rendered text textures keyed by (string, font, point size, colour,
+ * render mode) within a byte budget, evicting the least recently used.
+ * Returned textures are owned by the cache and stay valid until a later
+ * get() evicts them; the most recently returned texture is never evicted.
+ */
+class TextCache {
+  public:
+    struct Stats {
+      unsigned long hits;
+      unsigned long misses;
+      unsigned long evictions;
+      size_t bytes;
+      size_t entries;
+    };
+
+    TextCache(SDL_Renderer *pRenderer, size_t pByteBudget);
+    ~TextCache(void);
+    TextCache(const TextCache &) = delete;
+    TextCache &operator=(const TextCache &) = delete;
+
+    // Returns nullptr and leaves SDL_GetError set if rendering fails.
+    SDL_Texture *get(
+      const std::string &pMessage,
+      TTF_Font *pFont,
+      int pPointSize,
+      SDL_Color pColor,
+      TextRenderMode pMode = TextRenderMode::Blended
+    );
+    void setBudget(size_t pByteBudget);
+    const Stats &stats(void) const;
+    void clear(void);
+
+  private:
+    struct Key {
+      std::string message;
+      TTF_Font *font;
+      int pointSize;
+      Uint32 color;
+      TextRenderMode mode;
+      bool operator==(const Key &pOther) const;
+    };
+    struct KeyHash {
+      size_t operator()(const Key &pKey) const;
+    };
+    struct Entry {
+      Key key;
+      SDL_Texture *texture;
+      size_t bytes;
+    };
+    typedef std::list<Entry> Entries;
+
+    void evict(size_t pKeep);
+
+    SDL_Renderer *mRenderer;
+    size_t mByteBudget;
+    Stats mStats;
+    Entries mEntries;
+    std::unordered_map<Key, Entries::iterator, KeyHash> mIndex;
+};
+
+#endif // TEXT_CACHE_H
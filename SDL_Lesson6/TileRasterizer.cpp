@@ -0,0 +1,223 @@
+#include "TileRasterizer.h"
+
+#include <algorithm>
+#include <SDL2/SDL.h>
+
+#include "Utility.h"
+
+TileRasterizer::TileRasterizer(int pThreads, int pTileSize) :
+  mTileSize(std::max(8, pTileSize)),
+  mPixels(nullptr),
+  mWidth(0),
+  mHeight(0),
+  mColumns(0),
+  mGeneration(0),
+  mBusy(0),
+  mStopping(false),
+  mNextTile(0)
+{
+  int threads = 0 < pThreads ? pThreads : std::max(1, SDL_GetCPUCount());
+  mBlitters.resize(threads);
+  for (int i = 1; i < threads; i++) {
+    mThreads.push_back(std::thread(&TileRasterizer::work, this, i));
+  }
+}
+
+TileRasterizer::~TileRasterizer(void) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWake.notify_all();
+  for (std::thread &thread : mThreads) {
+    thread.join();
+  }
+  freeTiles();
+}
+
+int TileRasterizer::threads(void) const {
+  return mBlitters.size();
+}
+
+bool TileRasterizer::setLevel(BlitLevel pLevel) {
+  for (SoftwareBlitter &blitter : mBlitters) {
+    if (!blitter.setLevel(pLevel)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+BlitLevel TileRasterizer::level(void) const {
+  return mBlitters.front().level();
+}
+
+void TileRasterizer::draw(
+  SDL_Surface *pSource,
+  const SDL_Rect *pSourceRect,
+  const SDL_Rect &pDestination,
+  ScaleFilter pFilter,
+  bool pBlend
+) {
+  Command command;
+  command.source = pSource;
+  command.sourceRect = nullptr == pSourceRect ? SDL_Rect{0, 0, pSource->w, pSource->h} : *pSourceRect;
+  command.destination = pDestination;
+  command.filter = pFilter;
+  command.blend = pBlend;
+  command.color = 0;
+  mCommands.push_back(command);
+}
+
+void TileRasterizer::fill(const SDL_Rect *pRect, Uint32 pColor) {
+  Command command;
+  command.source = nullptr;
+  command.sourceRect = {0, 0, 0, 0};
+  // Resolved against the target in render().
+  command.destination = nullptr == pRect ? SDL_Rect{0, 0, -1, -1} : *pRect;
+  command.filter = ScaleFilter::Nearest;
+  command.blend = false;
+  command.color = pColor;
+  mCommands.push_back(command);
+}
+
+void TileRasterizer::freeTiles(void) {
+  for (Tile &tile : mTiles) {
+    Utility::cleanup(tile.view);
+  }
+  mTiles.clear();
+  mPixels = nullptr;
+}
+
+bool TileRasterizer::prepareTiles(SDL_Surface *pTarget) {
+  if (pTarget->pixels == mPixels && pTarget->w == mWidth && pTarget->h == mHeight) {
+    return true;
+  }
+  freeTiles();
+  mWidth = pTarget->w;
+  mHeight = pTarget->h;
+  mColumns = (mWidth + mTileSize - 1) / mTileSize;
+  // Each tile is a view into the target's pixels, so the blitters clip to
+  // the tile without sharing any state.
+  for (int y = 0; y < mHeight; y += mTileSize) {
+    for (int x = 0; x < mWidth; x += mTileSize) {
+      Tile tile;
+      tile.bounds = {x, y, std::min(mTileSize, mWidth - x), std::min(mTileSize, mHeight - y)};
+      tile.view = SDL_CreateRGBSurfaceWithFormatFrom(
+        static_cast<Uint8 *>(pTarget->pixels) + y * pTarget->pitch + x * 4,
+        tile.bounds.w,
+        tile.bounds.h,
+        32,
+        pTarget->pitch,
+        SDL_PIXELFORMAT_ARGB8888
+      );
+      if (nullptr == tile.view) {
+        freeTiles();
+        return false;
+      }
+      mTiles.push_back(tile);
+    }
+  }
+  mPixels = pTarget->pixels;
+  return true;
+}
+
+bool TileRasterizer::render(SDL_Surface *pTarget) {
+  if (SDL_PIXELFORMAT_ARGB8888 != pTarget->format->format) {
+    SDL_SetError("TileRasterizer needs an ARGB8888 surface");
+    mCommands.clear();
+    return false;
+  }
+  if (!prepareTiles(pTarget)) {
+    mCommands.clear();
+    return false;
+  }
+  if (SDL_MUSTLOCK(pTarget)) {
+    SDL_LockSurface(pTarget);
+  }
+
+  // Bin each draw into the tiles its clipped bounds touch, in draw order.
+  for (Tile &tile : mTiles) {
+    tile.commands.clear();
+  }
+  SDL_Rect bounds = {0, 0, mWidth, mHeight};
+  for (size_t i = 0; i < mCommands.size(); i++) {
+    Command &command = mCommands[i];
+    if (nullptr == command.source && command.destination.w < 0) {
+      command.destination = bounds;
+    }
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(&command.destination, &bounds, &visible)) {
+      continue;
+    }
+    int firstColumn = visible.x / mTileSize;
+    int lastColumn = (visible.x + visible.w - 1) / mTileSize;
+    int firstRow = visible.y / mTileSize;
+    int lastRow = (visible.y + visible.h - 1) / mTileSize;
+    for (int row = firstRow; row <= lastRow; row++) {
+      for (int column = firstColumn; column <= lastColumn; column++) {
+        mTiles[row * mColumns + column].commands.push_back(i);
+      }
+    }
+  }
+
+  mNextTile = 0;
+  if (!mThreads.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mGeneration++;
+      mBusy = mThreads.size();
+    }
+    mWake.notify_all();
+  }
+  rasterize(mBlitters.front());
+  if (!mThreads.empty()) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return 0 == mBusy; });
+  }
+
+  if (SDL_MUSTLOCK(pTarget)) {
+    SDL_UnlockSurface(pTarget);
+  }
+  mCommands.clear();
+  return true;
+}
+
+void TileRasterizer::rasterize(SoftwareBlitter &pBlitter) {
+  for (size_t index = mNextTile++; index < mTiles.size(); index = mNextTile++) {
+    Tile &tile = mTiles[index];
+    for (int i : tile.commands) {
+      const Command &command = mCommands[i];
+      // Blits are translation invariant, so a tile-relative destination
+      // samples exactly the source pixels the full-target blit would.
+      SDL_Rect destination = command.destination;
+      destination.x -= tile.bounds.x;
+      destination.y -= tile.bounds.y;
+      if (nullptr == command.source) {
+        pBlitter.fill(tile.view, &destination, command.color);
+      } else {
+        pBlitter.blit(command.source, &command.sourceRect, tile.view, &destination, command.filter, command.blend);
+      }
+    }
+  }
+}
+
+void TileRasterizer::work(int pIndex) {
+  unsigned long generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWake.wait(lock, [this, generation] { return mStopping || generation != mGeneration; });
+      if (mStopping) {
+        return;
+      }
+      generation = mGeneration;
+    }
+    rasterize(mBlitters[pIndex]);
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mBusy--;
+    }
+    mDone.notify_one();
+  }
+}
@@ -1,27 +1,52 @@
 #include <cstdlib>
-#include <cmath>
 #include <iostream>
+#include <string>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "Animator.h"
+#include "Benchmark.h"
 #include "Constants.h"
+#include "CpuCanvas.h"
+#include "DynamicTexture.h"
+#include "FontManager.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "GlyphCache.h"
+#include "LessonOptions.h"
+#include "Logger.h"
+#include "PerformanceOverlay.h"
+#include "ResourcePack.h"
+#include "ScrollingBackground.h"
+#include "SpriteBatch.h"
+#include "SurfacePool.h"
+#include "TextCache.h"
 #include "Utility.h"
 
-void logSdlError(std::ostream &pOutputStream, const std::string pMessage) {
-  pOutputStream << pMessage << " Error: " << SDL_GetError() << std::endl;
+void logSdlError(const char *pMessage) {
+  Logger::console().log(LogLevel::Error, "%s Error: %s", pMessage, SDL_GetError());
 }
 
 SDL_Texture *loadTexture(const std::string &pFileName, SDL_Renderer *pRenderer) {
   SDL_Texture *texture = IMG_LoadTexture(pRenderer, pFileName.c_str());
   if (nullptr == texture) {
-    logSdlError(std::cout, "LoadTexture");
+    logSdlError("LoadTexture");
   }
   return texture;
 }
 
 void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, SDL_Rect pDestination, SDL_Rect *pClip = nullptr) {
-  SDL_RenderCopy(pRenderer, pTexture, pClip, &pDestination);
+  CpuCanvas *canvas = CpuCanvas::current(pRenderer);
+  if (nullptr != canvas && canvas->draw(pTexture, pDestination, pClip)) {
+    return;
+  }
+  SpriteBatch *batch = SpriteBatch::current(pRenderer);
+  if (nullptr == batch) {
+    SDL_RenderCopy(pRenderer, pTexture, pClip, &pDestination);
+  } else {
+    batch->draw(pTexture, pDestination, pClip);
+  }
 }
 
 void renderTexture(
@@ -54,46 +79,59 @@ void renderTexture(SDL_Texture *pTexture, SDL_Renderer *pRenderer, int pPosition
   renderTexture(pTexture, pRenderer, destination, pClip);
 }
 
-TTF_Font *openFont(const std::string &pFontFileName, int pFontSize) {
-  TTF_Font *font = TTF_OpenFont(pFontFileName.c_str(), pFontSize);
+TTF_Font *openFont(FontManager &pFonts, const std::string &pFontFileName, int pFontSize) {
+  TTF_Font *font = pFonts.open(pFontFileName, pFontSize);
   if (nullptr == font) {
-    logSdlError(std::cout, "TTF_OpenFont");
+    logSdlError("TTF_OpenFont");
     return nullptr;
   }
   return font;
 }
 
-SDL_Texture *renderText(
+bool renderText(
   const std::string &pMessage,
   TTF_Font *pFont,
   SDL_Color pColor,
-  SDL_Renderer *pRenderer
+  GlyphCache &pGlyphs,
+  SurfacePool &pPool,
+  DynamicTexture &pTexture
 ) {
-  SDL_Surface *surface = TTF_RenderText_Blended(pFont, pMessage.c_str(), pColor);
+  SDL_Surface *surface = pGlyphs.render(pMessage, pFont, pColor, pPool);
   if (nullptr == surface) {
-    logSdlError(std::cout, "TTF_RenderText");
-    return nullptr;
+    logSdlError("GlyphCache");
+    return false;
   }
-  SDL_Texture *texture = SDL_CreateTextureFromSurface(pRenderer, surface);
-  if (nullptr == texture) {
-    logSdlError(std::cout, "CreateTexture");
+  bool updated = pTexture.update(surface, surface->clip_rect.w, surface->clip_rect.h);
+  if (!updated) {
+    logSdlError("DynamicTexture");
   }
-  SDL_FreeSurface(surface);
-  return texture;
+  pPool.release(surface);
+  return updated;
 }
 
 int main(int argc, char** argv) {
+  Benchmark benchmark;
+  LessonOptions options(LessonOptions::CPU_BLIT);
+  if (!benchmark.parse(argc, argv, options)) {
+    Benchmark::usage(std::cout, Constants::ApplicationName(), options);
+    return EXIT_FAILURE;
+  }
+  Constants::Config config;
+  if (!benchmark.prepare(config)) {
+    logSdlError("Config");
+    return EXIT_FAILURE;
+  }
   if (0 != SDL_Init(SDL_INIT_VIDEO)) {
-    std::cout << "Error: SDL_Init " << SDL_GetError() << std::endl;
+    Logger::console().log(LogLevel::Error, "Error: SDL_Init %s", SDL_GetError());
     return EXIT_FAILURE;
   }
   if (0 != TTF_Init()) {
-    logSdlError(std::cout, "TTF_Init");
+    logSdlError("TTF_Init");
     SDL_Quit();
     return EXIT_FAILURE;
   }
   if (IMG_INIT_PNG != (IMG_INIT_PNG & IMG_Init(IMG_INIT_PNG))) {
-    logSdlError(std::cout, "IMG_Init");
+    logSdlError("IMG_Init");
     SDL_Quit();
     return EXIT_FAILURE;
   }
@@ -101,84 +139,196 @@ int main(int argc, char** argv) {
     Constants::WindowTitle(),
     Constants::WindowPositionX(),
     Constants::WindowPositionY(),
-    Constants::WindowWidth(),
-    Constants::WindowHeight(),
-    SDL_WINDOW_SHOWN
+    config.windowWidth,
+    config.windowHeight,
+    benchmark.windowFlags(SDL_WINDOW_SHOWN)
   );
   if (nullptr == window) {
-    logSdlError(std::cout, "SDL_CreateWindow");
+    logSdlError("SDL_CreateWindow");
     SDL_Quit();
     return EXIT_FAILURE;
   }
   SDL_Renderer *renderer = SDL_CreateRenderer(
     window,
     Constants::DefaultRendererWindow(),
-    SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+    benchmark.rendererFlags(SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
   );
   if (nullptr == renderer) {
-    logSdlError(std::cout, "SDL_CreateRenderer");
+    logSdlError("SDL_CreateRenderer");
     Utility::cleanup(window);
     IMG_Quit();
     SDL_Quit();
     return EXIT_FAILURE;
   }
+  SpriteBatch batch(renderer);
   const std::string resourcePath = Constants::ResourcePath(Constants::ApplicationName());
-  TTF_Font *font = openFont(resourcePath + "twinklebear_ascii.ttf", 64);
-  SDL_Color image_color = {0xFF, 0xFF, 0xFF, 0xFF};
-  SDL_Texture *image = renderText("True type font test!", font, image_color, renderer);
+  // The pack is optional; without one, assets are read from res/.
+  ResourcePack pack;
+  pack.open(Constants::ResourcePackPath(), Constants::ResourcePath(""));
+  FontManager fonts(&pack);
+  TTF_Font *font = openFont(fonts, resourcePath + "twinklebear_ascii.ttf", 64);
+  TTF_Font *statFont = openFont(fonts, resourcePath + "twinklebear_ascii.ttf", 16);
+  TextCache textCache(renderer, Constants::TextCacheBudget());
   SDL_Color background_color = {0x00, 0x00, 0x66, 0xFF};
-  SDL_Texture *background = renderText("Background  ...  ", font, background_color, renderer);
-  TTF_CloseFont(font);
-  if (nullptr == image || nullptr == background) {
-    Utility::cleanup(image, background, renderer, window);
+  SDL_Texture *background = textCache.get("Background  ...  ", font, 64, background_color);
+  if (nullptr == background) {
+    logSdlError("TextCache");
+  }
+  if (nullptr == statFont || nullptr == background) {
+    textCache.clear();
+    fonts.clear();
+    Utility::cleanup(renderer, window);
     IMG_Quit();
     SDL_Quit();
     return EXIT_FAILURE;
   }
+  const std::string printable = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+  GlyphCache glyphs(renderer);
+  glyphs.preload(font, printable);
+  glyphs.preload(statFont, printable);
+  const std::string message = "True type font test!";
+  SDL_Color image_color = {0xFF, 0xFF, 0xFF, 0xFF};
+  int messageWidth, messageHeight;
+  glyphs.size(message, font, &messageWidth, &messageHeight);
+  // The frame counter changes every frame, so it keeps one streaming texture.
+  SurfacePool surfacePool;
+  DynamicTexture frameCounter(renderer);
+  int tileWidth = messageWidth / 2;
+  int tileHeight = messageHeight / 2;
+  ScrollingBackground scrollingBackground;
+  scrollingBackground.build(
+    renderer,
+    background,
+    nullptr,
+    tileWidth,
+    tileHeight,
+    config.windowWidth,
+    config.windowHeight
+  );
   bool done = false;
   int frame = 0;
+  FrameScheduler scheduler(config.framesPerSecond, benchmark.enabled() ? FrameMode::Uncapped : FrameMode::Paced);
+  FrameProfiler profiler;
+  PerformanceOverlay overlay(renderer, glyphs, statFont, config.framesPerSecond);
+  overlay.setVisible(0 != config.overlay);
+  Animator animator;
+  float pulseX, pulseY, orbitX, orbitY, sway;
+  animator.cosine(&pulseX, 1.0f, 0.7f, 2.0f);
+  animator.sine(&pulseY, 1.0f, 0.7f, 2.0f);
+  animator.cosine(&orbitX, 1.0f, 0.5f, 0.5f);
+  animator.sine(&orbitY, 1.0f, 0.5f, 1.0f);
+  animator.cosine(&sway, 0.0f, 1.0f, 1.0f / 3);
+  CpuCanvas cpu(renderer);
+  if (options.cpuBlit() && !cpu.create(
+    config.windowWidth,
+    config.windowHeight,
+    ScaleFilter::Nearest,
+    options.threads()
+  )) {
+    logSdlError("CpuCanvas");
+  }
+  benchmark.start();
   do {
+    scheduler.beginFrame();
+    profiler.beginFrame();
+    double seconds = scheduler.time();
+    animator.update(seconds);
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
       switch (event.type) {
+        case SDL_KEYDOWN:
+          if (SDLK_h == event.key.keysym.sym) {
+            overlay.toggle();
+            break;
+          }
+          done = true;
+          break;
         case SDL_QUIT:
         case SDL_MOUSEBUTTONDOWN:
-        case SDL_KEYDOWN:
           done = true;
           break;
         default:
           break;
       }
     }
+    profiler.mark(FramePhase::Events);
     SDL_RenderClear(renderer);
-    int tileWidth, tileHeight;
-    SDL_QueryTexture(image, nullptr, nullptr, &tileWidth, &tileHeight);
-    tileWidth /= 2;
-    tileHeight /= 2;
-    int offsetX = cos((float)frame / (Constants::FramesPerSecond() * 3)) * tileHeight - tileHeight;
-    int offsetY = (frame / 2) % tileWidth - tileWidth;
-    for (int y = offsetY; y < Constants::WindowHeight(); y += tileHeight) {
-      for (int x = offsetX; x < Constants::WindowWidth(); x += tileWidth) {
-        renderTexture(background, renderer, x, y, tileWidth, tileHeight);
+    profiler.mark(FramePhase::Clear);
+    batch.begin();
+    cpu.begin();
+    int offsetX = sway * tileHeight - tileHeight;
+    int offsetY = (int)(seconds * 30) % tileWidth - tileWidth;
+    if (scrollingBackground.ready()) {
+      scrollingBackground.render(renderer, offsetX, offsetY);
+    } else {
+      for (int y = offsetY; y < config.windowHeight; y += tileHeight) {
+        for (int x = offsetX; x < config.windowWidth; x += tileWidth) {
+          renderTexture(background, renderer, x, y, tileWidth, tileHeight);
+        }
       }
     }
-    int imageWidth, imageHeight;
-    SDL_QueryTexture(image, nullptr, nullptr, &imageWidth, &imageHeight);
-    imageWidth *= 1.0 + 0.7 * cos((float)frame / (Constants::FramesPerSecond() / 2));
-    imageHeight *= 1.0 + 0.7 * sin((float)frame / (Constants::FramesPerSecond() / 2));
-    int centerX = (Constants::WindowWidth() - imageWidth) / 2;
-    int centerY = (Constants::WindowHeight() - imageHeight) / 2;
-    int x = centerX * (1.0 + 0.5 * cos((float)frame / (2 * Constants::FramesPerSecond())));
-    int y = centerY * (1.0 + 0.5 * sin((float)frame / Constants::FramesPerSecond()));
-    renderTexture(image, renderer, x, y, imageWidth, imageHeight);
+    // Glyphs stay on the renderer, so they go over the CPU framebuffer.
+    cpu.end();
+    profiler.mark(FramePhase::Background);
+    int imageWidth = messageWidth;
+    int imageHeight = messageHeight;
+    imageWidth *= pulseX;
+    imageHeight *= pulseY;
+    int centerX = (config.windowWidth - imageWidth) / 2;
+    int centerY = (config.windowHeight - imageHeight) / 2;
+    int x = centerX * orbitX;
+    int y = centerY * orbitY;
+    SDL_Rect destination = {x, y, imageWidth, imageHeight};
+    glyphs.draw(message, font, image_color, destination);
+    if (renderText("Frame: " + std::to_string(frame), statFont, image_color, glyphs, surfacePool, frameCounter)) {
+      SDL_Rect counterRegion = frameCounter.region();
+      renderTexture(frameCounter.texture(), renderer, 8, 8, &counterRegion);
+    }
+    batch.end();
+    PerformanceOverlay::Frame stats = {
+      scheduler.frameSeconds(),
+      batch.drawCalls(),
+      batch.textureSwitches(),
+      textCache.stats().bytes + glyphs.textureBytes() + scrollingBackground.textureBytes() + frameCounter.textureBytes()
+    };
+    batch.resetStats();
+    overlay.record(stats);
+    overlay.draw(config.windowWidth - overlay.width() - 8, 8);
+    profiler.mark(FramePhase::Sprites);
     SDL_RenderPresent(renderer);
-    if (0 == frame % Constants::FramesPerSecond()) {
-      std::cout << "Frame: " << frame << std::endl;
+    profiler.mark(FramePhase::Present);
+    if (!benchmark.enabled() && 0 == frame % config.framesPerSecond) {
+      Logger::console().log(LogLevel::Info, "Frame: %d", frame);
     }
     frame++;
-    SDL_Delay(Constants::FrameWait());
+    done = benchmark.frameDone() || done;
+    scheduler.endFrame();
   } while (!done);
-  Utility::cleanup(image, renderer, window);
+  Logger::console().flush();
+  if (benchmark.enabled()) {
+    benchmark.report(std::cout, Constants::ApplicationName(), options, profiler);
+  } else {
+    profiler.report(std::cout);
+  }
+  if (cpu.ready() && !benchmark.enabled()) {
+    std::cout << "CpuCanvas blitted with " << SoftwareBlitter::name(cpu.blitter().level())
+      << " on " << cpu.threads() << " thread(s)" << std::endl;
+  }
+  cpu.clear();
+  scrollingBackground.clear();
+  frameCounter.clear();
+  surfacePool.clear();
+  glyphs.clear();
+  if (!benchmark.enabled()) {
+    const TextCache::Stats &textStats = textCache.stats();
+    std::cout << "TextCache hits: " << textStats.hits
+      << " misses: " << textStats.misses
+      << " evictions: " << textStats.evictions
+      << " bytes: " << textStats.bytes << std::endl;
+  }
+  textCache.clear();
+  fonts.clear();
+  Utility::cleanup(renderer, window);
   IMG_Quit();
   SDL_Quit();
   return EXIT_SUCCESS;
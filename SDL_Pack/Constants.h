@@ -0,0 +1,12 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include <string>
+
+namespace Constants {
+  extern char const * const ApplicationName(void);
+  extern std::string ResourcePath(const std::string &subDir);
+  extern std::string ResourcePackPath(void);
+};
+
+#endif // CONSTANTS_H
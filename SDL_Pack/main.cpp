@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL2/SDL.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <dirent.h>
+  #include <sys/stat.h>
+#endif
+
+#include "Constants.h"
+#include "ResourcePack.h"
+
+/*
+ * Pack tool: bundles a res/ tree into a single resource pack.
+ * Usage: SDL_Pack [resource-directory output-file]
+ */
+
+struct PackFile {
+  std::string name;
+  std::string path;
+};
+
+void listFiles(const std::string &pDirectory, const std::string &pPrefix, std::vector<PackFile> &pFiles) {
+  #ifdef _WIN32
+    const char PATH_SEP = '\\';
+  #else
+    const char PATH_SEP = '/';
+  #endif
+
+  std::vector<std::pair<std::string, bool> > entries;
+  #ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA((pDirectory + "*").c_str(), &entry);
+    if (INVALID_HANDLE_VALUE != find) {
+      do {
+        entries.push_back(std::make_pair(std::string(entry.cFileName), 0 != (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)));
+      } while (FindNextFileA(find, &entry));
+      FindClose(find);
+    }
+  #else
+    DIR *directory = opendir(pDirectory.c_str());
+    if (nullptr != directory) {
+      while (dirent *entry = readdir(directory)) {
+        struct stat status;
+        if (0 == stat((pDirectory + entry->d_name).c_str(), &status)) {
+          entries.push_back(std::make_pair(std::string(entry->d_name), S_ISDIR(status.st_mode)));
+        }
+      }
+      closedir(directory);
+    }
+  #endif
+
+  for (const std::pair<std::string, bool> &entry : entries) {
+    // Skips ".", ".." and hidden files.
+    if ('.' == entry.first[0]) {
+      continue;
+    }
+    if (entry.second) {
+      listFiles(pDirectory + entry.first + PATH_SEP, pPrefix + entry.first + "/", pFiles);
+    } else {
+      PackFile file = {pPrefix + entry.first, pDirectory + entry.first};
+      pFiles.push_back(file);
+    }
+  }
+}
+
+void pad(std::ofstream &pOutput, Uint64 &pOffset) {
+  static const char zeros[PACK_ALIGNMENT] = {0};
+  Uint64 padding = (PACK_ALIGNMENT - pOffset % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+  pOutput.write(zeros, padding);
+  pOffset += padding;
+}
+
+int main(int argc, char** argv) {
+  std::string resourcePath = 3 == argc ? argv[1] : Constants::ResourcePath("");
+  std::string packPath = 3 == argc ? argv[2] : Constants::ResourcePackPath();
+  if (resourcePath.empty() || packPath.empty()) {
+    std::cout << "Usage: " << Constants::ApplicationName() << " [resource-directory output-file]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  char last = resourcePath[resourcePath.size() - 1];
+  if ('/' != last && '\\' != last) {
+    resourcePath += '/';
+  }
+
+  std::vector<PackFile> files;
+  listFiles(resourcePath, "", files);
+  std::sort(files.begin(), files.end(), [](const PackFile &a, const PackFile &b) {
+    return a.name < b.name;
+  });
+
+  std::ofstream output(packPath.c_str(), std::ios::binary | std::ios::trunc);
+  if (!output) {
+    std::cout << "Error: could not create " << packPath << std::endl;
+    return EXIT_FAILURE;
+  }
+  PackHeader header;
+  memset(&header, 0, sizeof(header));
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  Uint64 offset = sizeof(header);
+
+  std::vector<PackEntry> entries;
+  std::string names;
+  for (const PackFile &file : files) {
+    std::ifstream input(file.path.c_str(), std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (!input.eof() && input.fail()) {
+      std::cout << "Error: could not read " << file.path << std::endl;
+      return EXIT_FAILURE;
+    }
+    pad(output, offset);
+    PackEntry entry = {packHash(file.name), offset, contents.size(), (Uint32)names.size(), (Uint32)file.name.size()};
+    entries.push_back(entry);
+    names += file.name;
+    output.write(contents.data(), contents.size());
+    offset += contents.size();
+  }
+
+  // Sorted by hash so the reader can binary search the mapped index.
+  std::sort(entries.begin(), entries.end(), [](const PackEntry &a, const PackEntry &b) {
+    return a.hash < b.hash;
+  });
+  pad(output, offset);
+  header.indexOffset = offset;
+  output.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(PackEntry));
+  offset += entries.size() * sizeof(PackEntry);
+  header.namesOffset = offset;
+  output.write(names.data(), names.size());
+
+  memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+  header.version = PACK_VERSION;
+  header.entryCount = entries.size();
+  output.seekp(0);
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  output.close();
+  if (!output) {
+    std::cout << "Error: could not write " << packPath << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Packed " << entries.size() << " files into " << packPath << std::endl;
+  return EXIT_SUCCESS;
+}